@@ -0,0 +1,110 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# * ********************************************************************************************************* *
+# *
+# * Copyright 2025 Oidis
+# *
+# * SPDX-License-Identifier: BSD-3-Clause
+# * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+# * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+# *
+# * ********************************************************************************************************* *
+"""Startup benchmark of Python WebixDapper.
+
+Every run is a fresh process as short-lived CLI job is. Module is loaded with compilation cache
+disabled, with empty cache and with cache filled by previous run. Time to the first API call is
+reported in milliseconds.
+
+Usage: python3 scripts/benchmark_startup.py [--runs N] [--wasm path/to/webix-dapper-wasm.wasm]
+"""
+
+import argparse
+import json
+import os
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+PROJECT_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+
+def child(wasm: str) -> None:
+    """Measure startup phases of this process and print them as JSON."""
+    start = time.perf_counter()
+    sys.path.insert(0, os.path.join(PROJECT_ROOT, "src"))
+    from python.dapper import WebixDapper  # pylint: disable=import-outside-toplevel
+
+    imported = time.perf_counter()
+    dapper = WebixDapper(wasm)
+    dapper.init()
+    initialized = time.perf_counter()
+    dapper.supported_vendor_ids()
+    called = time.perf_counter()
+    dapper.init()
+    reinitialized = time.perf_counter()
+    print(
+        json.dumps(
+            {
+                "import": (imported - start) * 1000,
+                "init": (initialized - imported) * 1000,
+                "first call": (called - initialized) * 1000,
+                "total": (called - start) * 1000,
+                "re-init": (reinitialized - called) * 1000,
+            }
+        )
+    )
+
+
+def run(wasm: str, cache: str) -> dict[str, float]:
+    env = dict(os.environ, WEBIX_DAPPER_CACHE=cache)
+    output = subprocess.run(
+        [sys.executable, __file__, "--child", "--wasm", wasm],
+        env=env,
+        check=True,
+        capture_output=True,
+        text=True,
+    ).stdout
+    return json.loads(output.splitlines()[-1])
+
+
+def main() -> None:
+    parser = argparse.ArgumentParser(
+        description=__doc__, formatter_class=argparse.RawTextHelpFormatter
+    )
+    parser.add_argument("--runs", type=int, default=5)
+    parser.add_argument(
+        "--wasm",
+        default=os.path.join(PROJECT_ROOT, "build", "build_wasm", "webix-dapper-wasm.wasm"),
+    )
+    parser.add_argument("--child", action="store_true", help=argparse.SUPPRESS)
+    args = parser.parse_args()
+
+    if args.child:
+        child(args.wasm)
+        return
+
+    with tempfile.TemporaryDirectory() as cache_dir:
+        scenarios: dict[str, list[dict[str, float]]] = {
+            "no cache": [],
+            "cold cache": [],
+            "warm cache": [],
+        }
+        for _ in range(args.runs):
+            scenarios["no cache"].append(run(args.wasm, ""))
+            for file in os.listdir(cache_dir):
+                os.remove(os.path.join(cache_dir, file))
+            scenarios["cold cache"].append(run(args.wasm, cache_dir))
+            scenarios["warm cache"].append(run(args.wasm, cache_dir))
+
+    phases = list(scenarios["no cache"][0])
+    print(f"{'median [ms]':<12}" + "".join(f"{phase:>12}" for phase in phases))
+    for name, results in scenarios.items():
+        medians = [statistics.median(result[phase] for result in results) for phase in phases]
+        print(f"{name:<12}" + "".join(f"{median:>12.1f}" for median in medians))
+
+
+if __name__ == "__main__":
+    main()
@@ -75,7 +75,7 @@ function main() {
   mkdir cmake-build-docker
   cd cmake-build-docker || exit 1
 
-  emcmake cmake ..
+  emcmake cmake .. -DWASM_PROFILE="$libProfile"
   cmake --build . -- -j 8 || exit 1
 
   echo "Build done"
@@ -56,6 +56,46 @@ function extendBuffer(data, packetSize) {
     return result;
 }
 
+// Compiled module of the page, shared by all instances so only the first Init() compiles it.
+let compiledWasm = null;
+
+function isNode() {
+    return typeof globalThis.process?.versions?.node === "string";
+}
+
+/**
+ * Emscripten module options which compile the binary by streaming API while it is still being downloaded.
+ * Engines keep code compiled from streamed responses in their code cache, so next page load skips compilation
+ * as long as the binary is served from HTTP cache. Node uses emscripten default loader.
+ * @param {function(Error)} fail Receives compilation or instantiation error.
+ * @return {object}
+ */
+function wasmOptions(fail) {
+    if (isNode() || typeof WebAssembly.compileStreaming !== "function") {
+        return {};
+    }
+    let wasmUrl = null;
+    return {
+        locateFile(file, scriptDirectory) {
+            const location = scriptDirectory + file;
+            if (file.endsWith(".wasm")) {
+                wasmUrl = location;
+            }
+            return location;
+        },
+        instantiateWasm(imports, receiveInstance) {
+            compiledWasm ??= WebAssembly.compileStreaming(fetch(wasmUrl, {credentials: "same-origin"}));
+            compiledWasm
+                .then(async (module) => receiveInstance(await WebAssembly.instantiate(module, imports), module))
+                .catch((error) => {
+                    compiledWasm = null;
+                    fail(error);
+                });
+            return {};
+        }
+    };
+}
+
 export class ProbeInfo {
     vendorId;
     productId;
@@ -69,6 +109,12 @@ export class ProbeInfo {
 }
 
 export class WebixDapper {
+    /**
+     * DAP info of already identified probes keyed by USB serial number, shared by all instances.
+     * @type {Map<string, ProbeInfo>}
+     */
+    static probeInfoCache = new Map();
+
     module = null;
     device = null;
 
@@ -76,11 +122,17 @@ export class WebixDapper {
     endpointIn = null;
     endpointOut = null;
     packetSize = 64;
+    memAP = -1;
 
     alwaysControlTransfer = false;
     trace = false;
     traceData = {inbound: [], outbound: []};
 
+    // WASM calls can not overlap (asyncify), so operations of all callers are chained here
+    #queue = Promise.resolve();
+    // CoreSight accesses waiting for the probe, all of them are sent together in shared DAP transfers
+    #batch = null;
+
     constructor() {
         this.setStdoutHandler(null);
         this.setStderrHandler(null);
@@ -198,7 +250,11 @@ export class WebixDapper {
      */
     async Init() {
         if (!this.module) {
-            this.module = await loadWasm();
+            let fail;
+            const failure = new Promise((resolve, reject) => {
+                fail = reject;
+            });
+            this.module = await Promise.race([loadWasm(wasmOptions(fail)), failure]);
         }
     }
 
@@ -282,32 +338,114 @@ export class WebixDapper {
     }
 
     /**
-     * Reads key information from USB device.
+     * Reads key information from USB device, info is cached by USB serial number so probe is queried only once.
+     * @param refresh {boolean} Query probe even if info is already cached.
      * @return {Promise<ProbeInfo>}
      */
-    async getProbeInfo() {
-        const data = await this.module.getProbeDAPInfo();
+    async getProbeInfo(refresh = false) {
+        const serialNumber = this.device?.serialNumber;
+        if (serialNumber && !refresh && WebixDapper.probeInfoCache.has(serialNumber)) {
+            return WebixDapper.probeInfoCache.get(serialNumber);
+        }
+        const data = await this.#run(() => this.module.getProbeDAPInfo());
         const retVal = new ProbeInfo();
         for (let key in data) {
             if (key in retVal && key in data) {
                 retVal[key] = data[key];
             }
         }
+        if (serialNumber) {
+            WebixDapper.probeInfoCache.set(serialNumber, retVal);
+        }
         return retVal;
     }
 
+    /**
+     * Lists already permitted USB probes from descriptors only, DAP info is filled from cache and fetched on demand
+     * by Open(probe.device) and getProbeInfo().
+     * @return {Promise<Object[]>}
+     */
+    async ListProbes() {
+        const vendorIds = this.SupportedVendorIDs;
+        const devices = await navigator.usb.getDevices();
+        return devices.filter((device) => vendorIds.includes(device.vendorId)).map((device) => ({
+            serialNo: device.serialNumber,
+            description: `${device.manufacturerName} ${device.productName}`,
+            vendorId: device.vendorId,
+            productId: device.productId,
+            info: WebixDapper.probeInfoCache.get(device.serialNumber) ?? null,
+            device
+        }));
+    }
+
+    /**
+     * Runs WASM call after all previously issued operations, so callers do not need to await each other.
+     * @param call {function(): Promise<*>}
+     * @return {Promise<*>}
+     */
+    #run(call) {
+        this.#batch = null;
+        const result = this.#queue.then(call);
+        this.#queue = result.catch(() => {});
+        return result;
+    }
+
+    // ops are flat (flags, address, data) triplets, all of them are kept together in one batch
+    #coreSight(ops) {
+        let batch = this.#batch;
+        if (!batch) {
+            batch = {ops: [], callbacks: []};
+            this.#batch = batch;
+            this.#queue = this.#queue.then(() => this.#runBatch(batch));
+        }
+        return new Promise((resolve, reject) => {
+            batch.callbacks.push({resolve, reject, start: batch.ops.length / 3, count: ops.length / 3});
+            batch.ops = batch.ops.concat(ops);
+        });
+    }
+
+    async #runBatch(batch) {
+        if (this.#batch === batch) {
+            this.#batch = null;
+        }
+        try {
+            if (batch.ops.length === 3) {
+                const [flags, address, data] = batch.ops;
+                const accessPort = (flags & 0x01) !== 0;
+                if (flags & 0x02) {
+                    batch.ops[2] = await this.module.coreSightRead(accessPort, address);
+                } else {
+                    await this.module.coreSightWrite(accessPort, address, data);
+                }
+            } else {
+                const ops = new Uint32Array(batch.ops);
+                await this.module.coreSightBatch(ops);
+                batch.ops = ops;
+            }
+            batch.callbacks.forEach(({resolve, start, count}) => {
+                const values = [];
+                for (let index = start; index < start + count; index++) {
+                    values.push(batch.ops[3 * index + 2] >>> 0);
+                }
+                resolve(values);
+            });
+        } catch (e) {
+            batch.callbacks.forEach(({reject}) => reject(e));
+        }
+    }
+
     /**
      * Reset target device.
      */
     async Reset() {
-        await this.module.reset();
+        await this.#run(() => this.module.reset());
     }
 
     /**
      * Reset DAP probe. (not sure what's the purpose)
      */
     async ProbeReset() {
-        await this.module.probeReset();
+        await this.#run(() => this.module.probeReset());
     }
 
     /**
@@ -316,7 +454,7 @@ export class WebixDapper {
      */
     async Connect() {
         try {
-            await this.module.connect();
+            await this.#run(() => this.module.connect());
         } catch (e) {
             console.error(e.message);
         }
@@ -328,7 +466,7 @@ export class WebixDapper {
      */
     async Disconnect() {
         try {
-            await this.module.disconnect();
+            await this.#run(() => this.module.disconnect());
         } catch (e) {
             console.error(e.message);
         }
@@ -342,7 +480,7 @@ export class WebixDapper {
     async CoreSightRead(accessPort, address) {
         let retVal;
         try {
-            retVal = (new Uint32Array([await this.module.coreSightRead(accessPort, address >>> 0)]))[0];
+            [retVal] = await this.#coreSight([(accessPort ? 0x01 : 0) | 0x02, address >>> 0, 0]);
         } catch (e) {
             console.error(e.message);
         }
@@ -357,13 +495,369 @@ export class WebixDapper {
      */
     async CoreSightWrite(accessPort, address, data) {
         try {
-            // x >>> 0 is to uint32 conversion
-            await this.module.coreSightWrite(accessPort, address >>> 0, data >>> 0);
+            await this.#coreSight([accessPort ? 0x01 : 0, address >>> 0, data >>> 0]);
         } catch (e) {
             console.error(e.message);
         }
     }
 
+    /**
+     * Runs dependent CoreSight accesses (e.g. MEM-AP TAR write followed by DRW access) as one unit, accesses
+     * issued by other callers are never placed in between.
+     * @param ops {Array<[boolean, boolean, number, number]>} Accesses as [accessPort, read, address, data].
+     * @return {Promise<number[]>} Read values (written data for writes) in order of ops.
+     */
+    async CoreSightTransaction(ops) {
+        let retVal;
+        try {
+            retVal = await this.#coreSight(ops.flatMap(([accessPort, read, address, data]) =>
+                [(accessPort ? 0x01 : 0) | (read ? 0x02 : 0), address >>> 0, (data ?? 0) >>> 0]));
+        } catch (e) {
+            console.error(e.message);
+        }
+        return retVal;
+    }
+
+    /**
+     * Connect to multi-drop SWD bus (DPv2). No target is selected after that, so use AddTarget or DiscoverTargets first.
+     * @return {Promise<void>}
+     */
+    async ConnectMultiDrop() {
+        await this.#run(() => this.module.connectMultiDrop());
+    }
+
+    /**
+     * Select target over TARGETSEL and register it for fast switching.
+     * @param targetSel {number} TARGETSEL value (TINSTANCE | TPARTNO | TDESIGNER | 1).
+     * @return {Promise<number>} Returns target handle, it is also active target after this call.
+     */
+    async AddTarget(targetSel) {
+        return this.#run(() => this.module.addTarget(targetSel >>> 0));
+    }
+
+    /**
+     * Probe all instances of given targets on multi-drop bus.
+     * @param targetIds {number[]} TARGETID values (TREVISION is ignored).
+     * @param instances {number} Number of TINSTANCE values to probe for each TARGETID.
+     * @return {Promise<number[]>} Returns handles of responding targets.
+     */
+    async DiscoverTargets(targetIds, instances = 16) {
+        const handles = [];
+        for (const targetId of targetIds) {
+            for (let instance = 0; instance < instances; instance++) {
+                try {
+                    handles.push(await this.AddTarget((instance << 28) | (targetId & 0x0FFFFFFF) | 1));
+                } catch {
+                    // no response from this instance
+                }
+            }
+        }
+        return handles;
+    }
+
+    /**
+     * Switch active target, SELECT cache of each target is kept so no AP reselection is needed after switch.
+     * @param handle {number} Target handle returned by AddTarget or DiscoverTargets.
+     * @return {Promise<void>}
+     */
+    async SelectTarget(handle) {
+        await this.#run(() => this.module.selectTarget(handle));
+    }
+
+    /**
+     * @return {Promise<Object[]>} Returns info about all registered multi-drop targets.
+     */
+    async GetTargets() {
+        return this.#run(async () => {
+            const targets = [];
+            const count = await this.module.getTargetCount();
+            for (let handle = 0; handle < count; handle++) {
+                const info = await this.module.getTargetInfo(handle);
+                info.targetSel >>>= 0;
+                info.dpidr >>>= 0;
+                targets.push(info);
+            }
+            return targets;
+        });
+    }
+
+    /**
+     * Requests are limited to the packet size supported by both host transport and probe, 64 bytes is used as lower bound.
+     * WebUSB transfers use the negotiated size from then on.
+     * @param size {number} Maximal packet size of host transport in bytes.
+     * @return {Promise<number>} Returns negotiated packet size.
+     */
+    async SetPacketSize(size) {
+        this.packetSize = await this.#run(() => this.module.setPacketSize(size));
+        return this.packetSize;
+    }
+
+    /**
+     * Loads CoreSight component map from storage and validates it against connected target. Full AP and ROM table scan
+     * is done only when there is no valid map stored for this target yet.
+     * @param targetName {string} Target name used in map key (see ProbeInfo.targetName).
+     * @param storage {Storage} Web Storage like object (getItem/setItem), map is not persisted when undefined.
+     * @return {Promise<string>} Returns serialized component map.
+     */
+    async DiscoverComponents(targetName, storage = globalThis.localStorage) {
+        return this.#run(async () => {
+            const key = "webix-dapper:components:" + await this.module.componentMapKey(targetName);
+            let data = storage?.getItem(key);
+            if (!data || !await this.module.restoreComponents(data)) {
+                data = await this.module.discoverComponents(targetName);
+                storage?.setItem(key, data);
+            }
+            this.memAP = await this.module.getMemAP();
+            return data;
+        });
+    }
+
+    /**
+     * Finds RTT control block in RAM range and reads its ring descriptors, control block found earlier is only validated.
+     * Target core keeps running, all accesses go through MEM-AP.
+     * @param start {number} RAM range start address.
+     * @param size {number} RAM range size in bytes.
+     * @param apsel {number} MEM-AP index, AP found by DiscoverComponents is used by default.
+     * @return {Promise<Object[]>} Returns info about all up channels.
+     */
+    async RttStart(start, size, apsel = -1) {
+        return this.#run(async () => {
+            const channels = [];
+            const count = await this.module.rttStart(apsel, start >>> 0, size >>> 0);
+            for (let index = 0; index < count; index++) {
+                channels.push(await this.module.rttGetChannelInfo(index));
+            }
+            return channels;
+        });
+    }
+
+    async RttStop() {
+        await this.#run(() => this.module.rttStop());
+    }
+
+    /**
+     * Write offsets of all up channels are polled in one transfer, only new data are read from target.
+     * @return {Promise<Uint8Array[]>} Returns new data of every up channel.
+     */
+    async RttPoll() {
+        return this.#run(async () => {
+            const data = [];
+            await this.module.rttPoll();
+            const count = await this.module.rttGetChannelCount();
+            for (let index = 0; index < count; index++) {
+                data.push((await this.module.rttRead(index)).slice());
+            }
+            return data;
+        });
+    }
+
+    /**
+     * Enables DWT PC sampling and clears collected histogram.
+     * @param apsel {number} MEM-AP index, AP of discovered DWT or core debug is used by default.
+     */
+    async ProfilerStart(apsel = -1) {
+        await this.#run(() => this.module.profilerStart(apsel));
+    }
+
+    /**
+     * Reads DWT PCSR while target is running, sample rate is given by packet size (see SetPacketSize).
+     * @param count {number} Number of samples.
+     * @return {Promise<number>} Returns number of valid samples.
+     */
+    async ProfilerSample(count) {
+        return this.#run(() => this.module.profilerSample(count));
+    }
+
+    /**
+     * @return {Promise<Map<number, number>>} Returns sample count of every PC, ordered from the hottest one.
+     */
+    async ProfilerGetHistogram() {
+        return this.#run(async () => {
+            const data = await this.module.profilerGetHistogram();
+            const histogram = new Map();
+            for (let i = 0; i < data.length; i += 2) {
+                histogram.set(data[i] >>> 0, data[i + 1]);
+            }
+            return histogram;
+        });
+    }
+
+    /**
+     * @return {Promise<Object>} Returns total samples, invalid samples and unique PC count.
+     */
+    async ProfilerGetStats() {
+        return this.#run(() => this.module.profilerGetStats());
+    }
+
+    async ProfilerStop() {
+        await this.#run(() => this.module.profilerStop());
+    }
+
+    /**
+     * Replaces host transport by in-process simulated CMSIS-DAP probe with ADIv5 target (AHB-AP 0, Cortex-M memory map).
+     * Non-zero instances with targetId make it multi-drop bus, only the instance picked by TARGETSEL responds.
+     * @param config {Object} Simulator configuration, missing fields are taken from defaults.
+     */
+    async SimulatorStart(config = {}) {
+        await this.#run(() => this.module.simulatorStart({
+            packetSize: 512,
+            waitPercent: 0,
+            seed: 1,
+            flashBase: 0x00000000,
+            flashSize: 0x100000,
+            ramBase: 0x20000000,
+            ramSize: 0x40000,
+            targetId: 0,
+            instances: 0,
+            ...config
+        }));
+    }
+
+    async SimulatorStop() {
+        await this.#run(() => this.module.simulatorStop());
+    }
+
+    /**
+     * @return {Promise<Object>} Returns number of packets, DP/AP accesses, injected WAITs and faults.
+     */
+    async SimulatorGetStats() {
+        return this.#run(() => this.module.simulatorGetStats());
+    }
+
+    /**
+     * Adds target memory region reported to debugger, regions must not overlap.
+     * @param region {Object} Region with type (0 ram, 1 flash, 2 rom, 3 peripheral), base, size and blockSize.
+     */
+    async AddMemoryRegion(region) {
+        await this.#run(() => this.module.addMemoryRegion({blockSize: 0, ...region}));
+    }
+
+    async ClearMemoryRegions() {
+        await this.#run(() => this.module.clearMemoryRegions());
+    }
+
+    /**
+     * Reads target memory at any alignment, through page cache when it is enabled.
+     * @param address {number} Start address.
+     * @param size {number} Number of bytes.
+     * @param apsel {number} MEM-AP index, AP found by DiscoverComponents is used by default.
+     * @return {Promise<Uint8Array>} Returns read bytes.
+     */
+    async MemoryRead(address, size, apsel = -1) {
+        return this.#run(async () => {
+            return (await this.module.memoryRead(apsel, address, size)).slice();
+        });
+    }
+
+    /**
+     * Writes target memory at any alignment, cached pages of written range are dropped.
+     * @param address {number} Start address.
+     * @param data {Uint8Array} Bytes to write.
+     * @param apsel {number} MEM-AP index, AP found by DiscoverComponents is used by default.
+     */
+    async MemoryWrite(address, data, apsel = -1) {
+        await this.#run(() => this.module.memoryWrite(apsel, address, data));
+    }
+
+    /**
+     * Runs scatter-gather memory operations in as few probe packets as possible. Consecutive operations of the same
+     * direction on RAM, flash and ROM regions are sorted and their overlapping or adjacent ranges merged (later write
+     * wins), reads of them may be widened to words and joined over small gaps. Operations on peripherals or memory
+     * outside of regions are kept in list order and never merged, so register sequences (e.g. watchdog unlock) are
+     * safe.
+     * @param ops {Array<Object>} Reads as {address, size} and writes as {address, data: Uint8Array}.
+     * @param apsel {number} MEM-AP index, AP found by DiscoverComponents is used by default.
+     * @return {Promise<Array<Uint8Array>>} Returns data of every read operation in order.
+     */
+    async MemoryBatch(ops, apsel = -1) {
+        // operations are packed as little endian [flags, address, size] words
+        const packed = new Uint8Array(ops.length * 12);
+        const words = new DataView(packed.buffer);
+        const writes = ops.filter((op) => op.data !== undefined);
+        const data = new Uint8Array(writes.reduce((size, op) => size + op.data.length, 0));
+        let dataOffset = 0;
+        ops.forEach((op, index) => {
+            const write = op.data !== undefined;
+            words.setUint32(index * 12, write ? 1 : 0, true);
+            words.setUint32(index * 12 + 4, op.address >>> 0, true);
+            words.setUint32(index * 12 + 8, write ? op.data.length : op.size, true);
+            if (write) {
+                data.set(op.data, dataOffset);
+                dataOffset += op.data.length;
+            }
+        });
+        return this.#run(async () => {
+            const result = await this.module.memoryBatch(apsel, packed, data);
+            const reads = [];
+            let offset = 0;
+            for (const op of ops.filter((item) => item.data === undefined)) {
+                reads.push(result.slice(offset, offset + op.size));
+                offset += op.size;
+            }
+            return reads;
+        });
+    }
+
+    /**
+     * Enables memory page cache used by MemoryRead and GDB server. ROM and flash regions are cached until write or reset,
+     * RAM regions only while core stays halted, peripherals are never cached and raw CoreSight AP writes drop all pages.
+     * @param enabled {boolean} False disables and empties the cache.
+     */
+    async MemoryCacheEnable(enabled = true) {
+        await this.#run(() => this.module.memoryCacheEnable(enabled));
+    }
+
+    async MemoryCacheInvalidate() {
+        await this.#run(() => this.module.memoryCacheInvalidate());
+    }
+
+    /**
+     * @return {Promise<Object>} Returns page hits, misses, bypassed target reads and invalidated pages.
+     */
+    async MemoryCacheGetStats() {
+        return this.#run(() => this.module.memoryCacheGetStats());
+    }
+
+    async MemoryCacheResetStats() {
+        await this.#run(() => this.module.memoryCacheResetStats());
+    }
+
+    /**
+     * Starts GDB remote serial protocol session, target core is halted.
+     * @param apsel {number} MEM-AP index, AP found by DiscoverComponents is used by default.
+     */
+    async GdbStart(apsel = -1) {
+        await this.#run(() => this.module.gdbStart(apsel));
+    }
+
+    /**
+     * @param data {string} Bytes received from GDB client as binary string.
+     * @return {Promise<string>} Returns bytes to be sent back, all packets of data are answered at once.
+     */
+    async GdbReceive(data) {
+        return this.#run(() => this.module.gdbReceive(data));
+    }
+
+    /**
+     * Should be called periodically while GdbRunning holds.
+     * @return {Promise<string>} Returns stop reply once target halts, empty string while it keeps running.
+     */
+    async GdbPoll() {
+        return this.#run(() => this.module.gdbPoll());
+    }
+
+    async GdbRunning() {
+        return this.#run(() => this.module.gdbRunning());
+    }
+
+    async GdbDetached() {
+        return this.#run(() => this.module.gdbDetached());
+    }
+
+    async GdbStop() {
+        await this.#run(() => this.module.gdbStop());
+    }
+
     async DPAPjs(justRead = false) {
         let mem_ap_ix = -1;
 
@@ -421,6 +915,10 @@ export class WebixDapper {
             if (mem_ap_ix >= 0) {
                 return;
             }
+            if (this.memAP >= 0) {
+                mem_ap_ix = this.memAP;
+                return;
+            }
             let memAPIX = [0, 1, 3];
             let memAPAddress = 0x20000000;
 
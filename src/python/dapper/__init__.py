@@ -18,21 +18,33 @@ Components
 * DapperFactory: Factory class for creating Dapper instances
 * DapperProbeInfo: Class containing probe information
 * WebixDapper: Main Dapper implementation class
+* AsyncWebixDapper: Asyncio session over WebixDapper
+* GdbServer: GDB remote serial protocol server over WebixDapper
+* SymbolMap: ELF function symbols for profiler histograms
 * WebixDapperWasm: WASM-based Dapper implementation
 * Uint8Array: Type for handling byte arrays
 * Interface: Enumeration of available interfaces
+* TransportSelector: Picks the fastest interface of a probe
 """
 
 from .core import Uint8Array
-from .interfaces import Interface
+from .gdb_server import GdbServer
+from .interfaces import Interface, TransportSelector
+from .profiler import SymbolMap, sample_profile
 from .webix_dapper import DapperFactory, DapperProbeInfo, WebixDapper
+from .webix_dapper_async import AsyncWebixDapper
 from .webix_dapper_wasm import WebixDapperWasm
 
 __all__ = [
+    "AsyncWebixDapper",
     "DapperFactory",
     "DapperProbeInfo",
+    "GdbServer",
     "WebixDapper",
     "WebixDapperWasm",
     "Uint8Array",
     "Interface",
+    "TransportSelector",
+    "SymbolMap",
+    "sample_profile",
 ]
@@ -0,0 +1,77 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2025 Oidis
+#
+# SPDX-License-Identifier: BSD-3-Clause
+
+"""This module provides GDB remote serial protocol server over local TCP socket.
+
+Protocol is handled by WASM module, this module only forwards client bytes and polls running target.
+All packets received in one chunk are answered by one send, so pipelined requests cost one round trip.
+"""
+
+import logging
+import select
+import socket
+
+from .webix_dapper import WebixDapper
+
+logger = logging.getLogger("dapper")
+
+# target state is checked with this period while it runs
+POLL_INTERVAL = 0.01
+
+
+class GdbServer:
+    """GDB server for connected WebixDapper.
+
+    :param dapper: Connected WebixDapper instance with discovered components
+    :param port: TCP port, gdb connects by "target extended-remote localhost:<port>"
+    :param ap_sel: MEM-AP index, see WebixDapper.gdb_start
+    """
+
+    def __init__(self, dapper: WebixDapper, port: int = 3333, ap_sel: int = -1) -> None:
+        """Initialize GdbServer instance.
+
+        :param dapper: Connected WebixDapper instance
+        :param port: TCP port
+        :param ap_sel: MEM-AP index
+        """
+        self.dapper = dapper
+        self.port = port
+        self.ap_sel = ap_sel
+
+    def serve_forever(self) -> None:
+        """Accept clients on localhost one after another."""
+        with socket.create_server(("127.0.0.1", self.port)) as listener:
+            logger.info(f"GDB server listening on localhost:{self.port}")
+            while True:
+                connection, _ = listener.accept()
+                with connection:
+                    self.serve(connection)
+
+    def serve(self, connection: socket.socket) -> None:
+        """Serve one client until it detaches or closes connection.
+
+        :param connection: Connected client socket
+        """
+        if connection.family in (socket.AF_INET, socket.AF_INET6):
+            connection.setsockopt(socket.IPPROTO_TCP, socket.TCP_NODELAY, 1)
+        self.dapper.gdb_start(self.ap_sel)
+        try:
+            while not self.dapper.gdb_detached():
+                timeout = POLL_INTERVAL if self.dapper.gdb_running() else None
+                readable, _, _ = select.select([connection], [], [], timeout)
+                if readable:
+                    data = connection.recv(4096)
+                    if not data:
+                        break
+                    reply = self.dapper.gdb_receive(data)
+                else:
+                    reply = self.dapper.gdb_poll()
+                if reply:
+                    connection.sendall(reply)
+        finally:
+            self.dapper.gdb_stop()
+            logger.info("GDB client disconnected")
@@ -11,6 +11,7 @@ import pkgutil
 from pathlib import Path
 
 from .interface import Interface
+from .transport_selector import TransportMeasurement, TransportSelector
 
 logger = logging.getLogger("InterfaceFactory")
 
@@ -35,4 +36,6 @@ class InterfaceFactory:
 __all__ = [
     "Interface",
     "InterfaceFactory",
+    "TransportMeasurement",
+    "TransportSelector",
 ]
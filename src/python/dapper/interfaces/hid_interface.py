@@ -5,7 +5,6 @@
 # Copyright 2025 Oidis
 #
 # SPDX-License-Identifier: BSD-3-Clause
-import ctypes
 import logging
 import platform
 from typing import Any
@@ -63,6 +62,7 @@ class HidInterface(Interface[hid.device]):
         self.device_info = info
 
         self.packet_size = 64
+        self.max_packet_size = 64
 
     @staticmethod
     def list_probes() -> list[Interface]:
@@ -123,7 +123,7 @@ class HidInterface(Interface[hid.device]):
     def read(self) -> Uint8Array:
         """Read data from HID interface.
 
-        :return: Data read from interface
+        :return: Data read from interface, valid until next read
         :raises RuntimeError: If device endpoint is not opened
         """
         if self._device is None:
@@ -134,7 +134,7 @@ class HidInterface(Interface[hid.device]):
                 "read:  (" + str(len(data)) + ") [" + ",".join(f"{x:02X}" for x in data[0:64]) + "]"
             )
 
-        return Uint8Array((ctypes.c_uint8 * len(data))(*data))
+        return self._received(data)
 
     def __exit__(self, exc_type: Any, exc_val: Any, exc_tb: Any) -> None:
         """Exit the context manager.
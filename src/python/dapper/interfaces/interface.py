@@ -5,8 +5,9 @@
 # Copyright 2025 Oidis
 #
 # SPDX-License-Identifier: BSD-3-Clause
+import ctypes
 from abc import abstractmethod
-from typing import Generic, TypeVar
+from typing import Generic, Optional, TypeVar, Union
 
 from ..core import Uint8Array
 
@@ -33,6 +34,8 @@ class Interface(Generic[T]):
         self.product: str = ""
         self.serial_no: str = ""
         self.packet_size: int = 0
+        self.max_packet_size: int = 0
+        self._rx_buffer: Optional[ctypes.Array] = None
 
     @classmethod
     @abstractmethod
@@ -113,3 +116,23 @@ class Interface(Generic[T]):
         :raises NotImplementedError: If not implemented in derived class
         """
         raise NotImplementedError(f"{self.__class__}.read() must be implemented.")
+
+    def _read_buffer(self) -> ctypes.Array:
+        """Get receive buffer of packet_size bytes, allocated again only when packet size changes.
+
+        :return: Receive buffer
+        """
+        if self._rx_buffer is None or len(self._rx_buffer) != self.packet_size:
+            self._rx_buffer = (ctypes.c_uint8 * self.packet_size)()
+        return self._rx_buffer
+
+    def _received(self, data: Union[bytes, list[int]]) -> Uint8Array:
+        """Copy received packet into receive buffer.
+
+        :param data: Received packet
+        :return: View of receive buffer, valid until next read
+        """
+        buffer = self._read_buffer()
+        size = min(len(data), len(buffer))
+        ctypes.memmove(buffer, bytes(data[0:size]), size)
+        return Uint8Array(buffer, 0, size)
@@ -0,0 +1,121 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2025 Oidis
+#
+# SPDX-License-Identifier: BSD-3-Clause
+import ctypes
+import logging
+import statistics
+import time
+from dataclasses import dataclass
+
+from ..core import Uint8Array
+from .interface import Interface
+
+logger = logging.getLogger(__name__)
+
+
+@dataclass
+class TransportMeasurement:
+    """Result of one transport probing.
+
+    :param type: Interface type (see Interface.type)
+    :param packet_size: DAP packet size supported by both probe and host transport
+    :param latency: Median round trip of DAP_Info command in seconds
+    """
+
+    type: str
+    packet_size: int
+    latency: float
+
+    @property
+    def throughput(self) -> float:
+        """Estimated throughput in bytes per second, one full packet per round trip.
+
+        :return: Bytes per second
+        """
+        return self.packet_size / max(self.latency, 1e-6)
+
+
+class TransportSelector:
+    """Picks the fastest of transports exposing the same probe (MCU-Link offers HID, USB v1 and v2).
+
+    Static Interface.priority() only orders listing, selection opens every candidate once, times
+    DAP_Info packet size command and keeps the transport with the best packet size to latency
+    ratio. Decision is cached by probe serial number for the lifetime of the process.
+    """
+
+    ROUND_TRIPS = 8
+    choices: dict[str, str] = {}
+    measurements: dict[str, list[TransportMeasurement]] = {}
+
+    @classmethod
+    def preferred(cls, candidates: list[Interface]) -> Interface:
+        """Get already selected transport without probing.
+
+        :param candidates: Interfaces of one probe ordered by priority
+        :return: Cached choice or the first candidate
+        """
+        chosen = cls.choices.get(candidates[0].serial_no)
+        return next((c for c in candidates if c.type == chosen), candidates[0])
+
+    @classmethod
+    def select(cls, candidates: list[Interface]) -> Interface:
+        """Select the fastest transport, candidates are probed only when there is no cached choice.
+
+        Candidates which fail to open or answer are skipped, priority order wins when throughput is
+        equal or when no candidate could be measured.
+
+        :param candidates: Interfaces of one probe ordered by priority
+        :return: Selected interface
+        """
+        serial_no = candidates[0].serial_no
+        if len(candidates) > 1 and serial_no not in cls.choices:
+            results: list[TransportMeasurement] = []
+            for candidate in candidates:
+                try:
+                    results.append(cls.measure(candidate))
+                except Exception as e:  # pylint: disable=broad-exception-caught
+                    logger.info(f"Transport {candidate.type} of {serial_no} skipped: {e}")
+            cls.measurements[serial_no] = results
+            if results:
+                best = max(results, key=lambda m: m.throughput)
+                logger.info(
+                    f"Transport {best.type} selected for {serial_no}, "
+                    f"packet size {best.packet_size}, latency {best.latency * 1e3:.3f} ms"
+                )
+                cls.choices[serial_no] = best.type
+        return cls.preferred(candidates)
+
+    @classmethod
+    def measure(cls, interface: Interface) -> TransportMeasurement:
+        """Open interface and time DAP_Info packet size command.
+
+        :param interface: Closed interface to measure, it is closed again afterwards
+        :return: Measurement of interface
+        :raises RuntimeError: If probe response is not valid
+        """
+        interface.open()
+        try:
+            buffer = (ctypes.c_uint8 * max(interface.packet_size, 2))()
+            buffer[0] = 0x00  # DAP_Info
+            buffer[1] = 0xFF  # packet size
+            request = Uint8Array(buffer)
+            latencies = []
+            probe_packet_size = 0
+            for _ in range(cls.ROUND_TRIPS):
+                start = time.perf_counter()
+                interface.write(request)
+                response = interface.read()
+                latencies.append(time.perf_counter() - start)
+                if len(response) < 4 or response[0] != 0x00 or response[1] != 2:
+                    raise RuntimeError("Invalid DAP_Info response")
+                probe_packet_size = response[2] | (response[3] << 8)
+        finally:
+            interface.close()
+        return TransportMeasurement(
+            interface.type,
+            min(probe_packet_size, interface.max_packet_size),
+            statistics.median(latencies),
+        )
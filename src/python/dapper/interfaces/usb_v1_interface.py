@@ -5,7 +5,6 @@
 # Copyright 2025 Oidis
 #
 # SPDX-License-Identifier: BSD-3-Clause
-import ctypes
 import logging
 import queue
 import threading
@@ -63,9 +62,11 @@ class UsbV1Interface(Interface[usb.core.Device]):
         self.vid = device.idVendor
         self.pid = device.idProduct
         self.packet_size = 64
+        self.max_packet_size = 64
 
         self.thread: Optional[threading.Thread] = None
         self.interface_number = 0
+        self.kernel_driver_detached = False
         self.worker_stop_flag = threading.Event()
         self.data_fifo_rx: queue.SimpleQueue[bytes] = queue.SimpleQueue()
         self.read_mutex = threading.Semaphore(0)
@@ -129,6 +130,9 @@ class UsbV1Interface(Interface[usb.core.Device]):
         if self._endpoint_in is None or self._endpoint_out is None:
             raise RuntimeError("Unable to find USB device endpoints.")
 
+        # HID report carries one DAP packet
+        self.max_packet_size = self._endpoint_in.wMaxPacketSize
+        self.packet_size = self.max_packet_size
         self.interface_number = interface.bInterfaceNumber
         self._claim_interface()
 
@@ -138,6 +142,7 @@ class UsbV1Interface(Interface[usb.core.Device]):
         try:
             if self._device.is_kernel_driver_active(self.interface_number):
                 self._device.detach_kernel_driver(self.interface_number)
+                self.kernel_driver_detached = True
         except usb.core.USBError as e:
             logger.warning(f"kernel driver detach failed: {e}")
         except RuntimeError:
@@ -156,6 +161,13 @@ class UsbV1Interface(Interface[usb.core.Device]):
             self.thread.join()
         self.worker_stop_flag.clear()
         usb.util.release_interface(self._device, self.interface_number)
+        if self.kernel_driver_detached:
+            # give interface back to HID driver, so HID transport of the same probe stays usable
+            try:
+                self._device.attach_kernel_driver(self.interface_number)
+            except usb.core.USBError as e:
+                logger.warning(f"kernel driver attach failed: {e}")
+            self.kernel_driver_detached = False
         usb.util.dispose_resources(self._device)
         self._endpoint_in = None
         self._endpoint_out = None
@@ -177,7 +189,7 @@ class UsbV1Interface(Interface[usb.core.Device]):
     def read(self) -> Uint8Array:
         """Read data from USB interface.
 
-        :return: Data read from interface
+        :return: Data read from interface, valid until next read
         :raises RuntimeError: If device endpoint is not opened
         """
 
@@ -189,7 +201,7 @@ class UsbV1Interface(Interface[usb.core.Device]):
         except queue.Empty as e:
             raise RuntimeError("No data available.") from e
 
-        return Uint8Array((ctypes.c_uint8 * len(data))(*data))
+        return self._received(data)
 
     def _start_worker(self) -> None:
         """Worker thread initiator."""
@@ -212,14 +224,13 @@ class UsbV1Interface(Interface[usb.core.Device]):
 
         logger.debug("receiver worker starting")
         try:
+            rx_array = usb.util.create_buffer(self.max_packet_size)
             while not self.worker_stop_flag.is_set():
                 self.read_mutex.acquire()
                 if not self.worker_stop_flag.is_set():
                     if self._endpoint_in is not None:
-                        read_data = self._endpoint_in.read(
-                            self._endpoint_in.wMaxPacketSize, 10000
-                        ).tobytes()
-                        self.data_fifo_rx.put(read_data)
+                        size = self._endpoint_in.read(rx_array, 10000)
+                        self.data_fifo_rx.put(bytes(memoryview(rx_array)[0:size]))
         except Exception as e:
             logger.debug(f"receiver worker failed: {e}")
 
@@ -7,7 +7,7 @@
 # SPDX-License-Identifier: BSD-3-Clause
 import ctypes
 import logging
-from typing import Optional
+from typing import Any, Optional
 
 from ..core import Uint8Array
 from . import Interface
@@ -35,6 +35,9 @@ class UsbV2Interface(Interface[usb.core.Device]):
     and handles USB device configuration.
     """
 
+    MAX_PACKET_SIZE = 0xFFFF  # bulk transfer is not limited by endpoint, probe reports 16 bit size
+    WRITE_TIMEOUT = 10000
+
     @classmethod
     def is_available(cls) -> bool:
         """Returns true if interface is available."""
@@ -61,6 +64,8 @@ class UsbV2Interface(Interface[usb.core.Device]):
         self.vid = device.idVendor
         self.pid = device.idProduct
         self.packet_size = 64
+        self.max_packet_size = self.MAX_PACKET_SIZE
+        self._rx_array: Optional[Any] = None
 
     @staticmethod
     def list_probes() -> list[Interface]:
@@ -124,15 +129,31 @@ class UsbV2Interface(Interface[usb.core.Device]):
             raise RuntimeError("Device endpoint needs to be opened first.")
         if not isinstance(data, Uint8Array):
             raise RuntimeError("Data must be an instance of Uint8Array.")
-        self._endpoint_out.write(data.buffer, self.packet_size)
+        self._endpoint_out.write(data.buffer, self.WRITE_TIMEOUT)
 
     def read(self) -> Uint8Array:
         """Read data from USB interface.
 
-        :return: Data read from interface
+        Whole packet is received by one bulk transfer straight into receive buffer, no copy is
+        made. The transfer spans as many endpoint packets as the response needs, so large DAP
+        packets still cost one call. Responses of several DAP commands are not read in one batch,
+        WASM core waits for each response before it sends next command (no DAP pipelining).
+
+        :return: Data read from interface, valid until next read
         :raises RuntimeError: If device endpoint is not opened
         """
         if self._endpoint_in is None:
             raise RuntimeError("Device endpoint needs to be opened first.")
-        data = self._endpoint_in.read(self.packet_size)
-        return Uint8Array((ctypes.c_uint8 * len(data))(*data))
+        buffer = self._read_buffer()
+        size = self._endpoint_in.read(self._rx_array)
+        return Uint8Array(buffer, 0, size)
+
+    def _read_buffer(self) -> ctypes.Array:
+        """Get receive buffer sharing memory with array passed to bulk transfer.
+
+        :return: Receive buffer
+        """
+        if self._rx_buffer is None or len(self._rx_buffer) != self.packet_size:
+            self._rx_array = usb.util.create_buffer(self.packet_size)
+            self._rx_buffer = (ctypes.c_uint8 * self.packet_size).from_buffer(self._rx_array)
+        return self._rx_buffer
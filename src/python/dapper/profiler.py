@@ -0,0 +1,139 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2025 Oidis
+#
+# SPDX-License-Identifier: BSD-3-Clause
+
+"""This module provides statistical profiling over DWT PC sampling.
+
+PC samples are collected by WebixDapper without halting the target, this module drives
+the collection and resolves sampled addresses to functions from ELF symbol table.
+"""
+
+import bisect
+import struct
+from typing import NamedTuple, Optional
+
+from .webix_dapper import WebixDapper
+
+SHT_SYMTAB = 2
+STT_FUNC = 2
+
+
+class Symbol(NamedTuple):
+    """Function symbol from ELF file."""
+
+    address: int
+    size: int
+    name: str
+
+
+class SymbolMap:
+    """Address to function map.
+
+    :param symbols: Function symbols, Thumb bit of address is ignored
+    """
+
+    def __init__(self, symbols: list[Symbol]) -> None:
+        """Initialize SymbolMap instance.
+
+        :param symbols: Function symbols
+        """
+        self.symbols = sorted(
+            (Symbol(symbol.address & ~1, symbol.size, symbol.name) for symbol in symbols),
+            key=lambda symbol: symbol.address,
+        )
+        self._addresses = [symbol.address for symbol in self.symbols]
+
+    @classmethod
+    def from_elf(cls, path: str) -> "SymbolMap":
+        """Load function symbols from ELF file.
+
+        :param path: Path to ELF file with symbol table
+        :return: SymbolMap instance
+        :raises ValueError: If file is not little-endian ELF or it has no symbol table
+        """
+        with open(path, "rb") as file:
+            data = file.read()
+        if data[:4] != b"\x7fELF" or data[5] != 1:
+            raise ValueError(f"{path} is not little-endian ELF file")
+        elf64 = data[4] == 2
+        if elf64:
+            sh_offset, sh_entsize, sh_num = struct.unpack_from("<Q10xHH", data, 0x28)
+            section_format, symbol_format = "<IIQQQQIIQQ", "<IBBHQQ"
+        else:
+            sh_offset, sh_entsize, sh_num = struct.unpack_from("<I10xHH", data, 0x20)
+            section_format, symbol_format = "<IIIIIIIIII", "<IIIBBH"
+
+        sections = [
+            struct.unpack_from(section_format, data, sh_offset + index * sh_entsize)
+            for index in range(sh_num)
+        ]
+        symtabs = [section for section in sections if section[1] == SHT_SYMTAB]
+        if not symtabs:
+            raise ValueError(f"{path} has no symbol table")
+        symbols = []
+        for section in symtabs:
+            offset, size, link, entsize = section[4], section[5], section[6], section[9]
+            strtab_offset = sections[link][4]
+            for entry in range(offset, offset + size, entsize):
+                fields = struct.unpack_from(symbol_format, data, entry)
+                if elf64:
+                    name, info, _, _, value, sym_size = fields
+                else:
+                    name, value, sym_size, info, _, _ = fields
+                if info & 0x0F != STT_FUNC or sym_size == 0:
+                    continue
+                end = data.index(b"\0", strtab_offset + name)
+                symbols.append(
+                    Symbol(value, sym_size, data[strtab_offset + name : end].decode("utf-8"))
+                )
+        return cls(symbols)
+
+    def resolve(self, address: int) -> Optional[str]:
+        """Find function containing address.
+
+        :param address: Code address
+        :return: Function name or None when address is not inside any function
+        """
+        index = bisect.bisect_right(self._addresses, address) - 1
+        if index >= 0:
+            symbol = self.symbols[index]
+            if address < symbol.address + symbol.size:
+                return symbol.name
+        return None
+
+    def function_histogram(self, histogram: dict[int, int]) -> list[tuple[str, int]]:
+        """Aggregate PC histogram per function.
+
+        :param histogram: Sample count of every PC
+        :return: Function names (or addresses when unresolved) with sample counts, hottest first
+        """
+        functions: dict[str, int] = {}
+        for address, count in histogram.items():
+            name = self.resolve(address) or f"0x{address:08X}"
+            functions[name] = functions.get(name, 0) + count
+        return sorted(functions.items(), key=lambda item: item[1], reverse=True)
+
+
+def sample_profile(
+    dapper: WebixDapper, samples: int, batch: int = 4096, ap_sel: int = -1
+) -> dict[int, int]:
+    """Collect PC histogram of running target.
+
+    :param dapper: Connected WebixDapper instance
+    :param samples: Total number of PCSR reads
+    :param batch: Number of reads sent to WASM module at once
+    :param ap_sel: MEM-AP index, see WebixDapper.profiler_start
+    :return: Sample count of every PC, ordered from the hottest one
+    """
+    dapper.profiler_start(ap_sel)
+    try:
+        while samples > 0:
+            count = min(samples, batch)
+            dapper.profiler_sample(count)
+            samples -= count
+    finally:
+        dapper.profiler_stop()
+    return dapper.profiler_histogram()
@@ -13,13 +13,17 @@ including probe discovery, connection handling, and communication. The module su
 various probe interfaces and provides data structures for probe information management.
 """
 
+import ctypes
 import logging
+import os
+import re
+import struct
 from dataclasses import dataclass
 from time import sleep
 from typing import Any, Callable, Optional, Union, cast
 
 from .core import Uint8Array
-from .interfaces import Interface, InterfaceFactory
+from .interfaces import Interface, InterfaceFactory, TransportSelector
 from .webix_dapper_wasm import WebixDapperWasm
 
 logger = logging.getLogger("dapper")
@@ -27,6 +31,12 @@ logger = logging.getLogger("dapper")
 # todo(mkelnar) replace by trace flag and prepare formatter stdout/json for it
 deep_trace: bool = True
 
+# CSYSPWRUPACK | CDBGPWRUPACK in DP CTRL/STAT
+POWER_ACK_MASK = 0x80 << 24 | 0x20 << 24
+
+# memory region type names in order of MemoryRegionType of WASM module
+MEMORY_REGION_TYPES = ["ram", "flash", "rom", "peripheral"]
+
 
 @dataclass
 class DapperProbeInfo:
@@ -86,10 +96,14 @@ class ProbeInfo:
 class WebixDapper:  # pylint: disable=too-many-public-methods
     """WebixDapper class for handling WASM-based DAP operations."""
 
-    def __init__(self, context_path: Optional[str] = None) -> None:
+    # DAP info of already identified probes keyed by USB serial number, shared by all instances
+    probe_info_cache: dict[str, ProbeInfo] = {}
+
+    def __init__(self, context_path: Optional[str] = None, fast_path: bool = True) -> None:
         """Initialize WebixDapper instance.
 
         :param context_path: Optional path to the context
+        :param fast_path: Use direct packet transfer and typed exports when WASM module provides them
         """
         self._module: Optional[WebixDapperWasm] = None
         self.interface: Optional[Interface] = None
@@ -101,6 +115,12 @@ class WebixDapper:  # pylint: disable=too-many-public-methods
         self.write_data_handler: Optional[Callable] = None
 
         self.context_path = context_path
+        self.fast_path = fast_path
+        self.mem_ap: int = -1
+        self._core_sight_read: Optional[Callable[[int, int], int]] = None
+        self._core_sight_write: Optional[Callable[[int, int, int], None]] = None
+        self._core_sight_batch_buffer: Optional[Callable[[int], int]] = None
+        self._core_sight_batch: Optional[Callable[[int], None]] = None
 
     @property
     def module(self) -> WebixDapperWasm:
@@ -271,6 +291,13 @@ class WebixDapper:  # pylint: disable=too-many-public-methods
         module_instance.register_handler(writeData)
         module_instance.register_handler(stdout)
         module_instance.register_handler(stderr)
+        if self.fast_path and module_instance.enable_host_transfer(self.write_data, self.read_data):
+            self._core_sight_read = module_instance.direct_export("dapperCoreSightRead")
+            self._core_sight_write = module_instance.direct_export("dapperCoreSightWrite")
+            self._core_sight_batch_buffer = module_instance.direct_export(
+                "dapperCoreSightBatchBuffer"
+            )
+            self._core_sight_batch = module_instance.direct_export("dapperCoreSightBatch")
         self._module = module_instance
 
     def reinit_target(self) -> None:
@@ -304,8 +331,9 @@ class WebixDapper:  # pylint: disable=too-many-public-methods
             raise RuntimeError("Probe is undefined.")
         self.interface = device
 
-        # todo(mkelnar) add checker to identify device and decide to use UsbInterface or HidInterface
         self.interface.open()
+        # packets as large as both probe and host transport allow, HID stays at its report size
+        self.set_packet_size(self.interface.max_packet_size)
 
         self.get_probe_dap_info()
 
@@ -318,11 +346,12 @@ class WebixDapper:  # pylint: disable=too-many-public-methods
             raise RuntimeError("Device interface needs to be opened first.")
         self.interface.close()
 
-    def power_control(self, sys_power: bool) -> None:
-        """Control device power.
+    @staticmethod
+    def power_control_request(sys_power: bool) -> tuple[int, int]:
+        """Get CTRL/STAT power-up request and its acknowledge value.
 
         :param sys_power: True for system power, False for debug power
-        :raises RuntimeError: If failed to control device power
+        :return: Request value and expected acknowledge bits (see POWER_ACK_MASK)
         """
         # Request value for power control command
         req = 0x0F << 8
@@ -335,6 +364,15 @@ class WebixDapper:  # pylint: disable=too-many-public-methods
             # Set debug power control bit
             req |= 0x10 << 24
             check_status = 0x20 << 24
+        return req, check_status
+
+    def power_control(self, sys_power: bool) -> None:
+        """Control device power.
+
+        :param sys_power: True for system power, False for debug power
+        :raises RuntimeError: If failed to control device power
+        """
+        req, check_status = self.power_control_request(sys_power)
 
         # Write power control request
         self.core_sight_write(False, 0x04, req)
@@ -347,7 +385,7 @@ class WebixDapper:  # pylint: disable=too-many-public-methods
             sleep(0.1)
             ret = self.core_sight_read(False, 0x04)
             # Check if power control status matches expected value
-            if (ret & (0x80 << 24 | 0x20 << 24)) == check_status:
+            if (ret & POWER_ACK_MASK) == check_status:
                 succeed = True
                 break
             index -= 1
@@ -364,14 +402,23 @@ class WebixDapper:  # pylint: disable=too-many-public-methods
         self.power_control(False)
         self._stdout_handler("Debug Power True")
 
-    def get_probe_dap_info(self) -> ProbeInfo:
+    def get_probe_dap_info(self, refresh: bool = False) -> ProbeInfo:
         """Get probe DAP information.
 
+        Info is cached by USB serial number of opened interface, so probe is queried only once.
+
+        :param refresh: Query probe even if info is already cached
         :return: ProbeInfo object containing DAP information
         """
+        serial_no = self.interface.serial_no if self.interface is not None else ""
+        if serial_no and not refresh and serial_no in WebixDapper.probe_info_cache:
+            return WebixDapper.probe_info_cache[serial_no]
         # pylint: disable=no-member
         data = self.module.getProbeDAPInfo()  # type: ignore[attr-defined]
-        return ProbeInfo.from_dict(data)
+        info = ProbeInfo.from_dict(data)
+        if serial_no:
+            WebixDapper.probe_info_cache[serial_no] = info
+        return info
 
     def reset(self) -> None:
         """Reset the device."""
@@ -385,6 +432,8 @@ class WebixDapper:  # pylint: disable=too-many-public-methods
         :param address: Address to read from
         :return: Read value
         """
+        if self._core_sight_read is not None:
+            return self._core_sight_read(int(access_port), address) & 0xFFFFFFFF
         # pylint: disable=no-member
         return self.module.coreSightRead(access_port, address) & 0xFFFFFFFF  # type: ignore[attr-defined]
 
@@ -395,9 +444,436 @@ class WebixDapper:  # pylint: disable=too-many-public-methods
         :param address: Address to write to
         :param data: Data to write
         """
+        if self._core_sight_write is not None:
+            self._core_sight_write(int(access_port), address, data)
+            return
         # pylint: disable=no-member
         self.module.coreSightWrite(access_port, address, data)  # type: ignore[attr-defined]
 
+    def core_sight_batch(self, ops: list[tuple[bool, bool, int, int]]) -> list[int]:
+        """Run independent CoreSight accesses packed into shared DAP transfers.
+
+        :param ops: List of (access_port, read, address, data) tuples, data is ignored for reads
+        :return: Read value for every read access, written data for writes
+        """
+        if self._core_sight_batch is None or self._core_sight_batch_buffer is None:
+            values = []
+            for access_port, read, address, data in ops:
+                if read:
+                    data = self.core_sight_read(access_port, address)
+                else:
+                    self.core_sight_write(access_port, address, data)
+                values.append(data)
+            return values
+        if not ops:
+            return []
+        words: list[int] = []
+        for access_port, read, address, data in ops:
+            words += [int(access_port) | int(read) << 1, address & 0xFFFFFFFF, data & 0xFFFFFFFF]
+        layout = f"<{len(words)}I"
+        ptr = self._core_sight_batch_buffer(len(ops))
+        self.module.memory.write(self.module.store, struct.pack(layout, *words), ptr)
+        self._core_sight_batch(len(ops))
+        words = list(
+            struct.unpack(
+                layout, self.module.memory.read(self.module.store, ptr, ptr + 4 * len(words))
+            )
+        )
+        return words[2::3]
+
+    def connect_multi_drop(self) -> None:
+        """Connect to multi-drop SWD bus (DPv2) without selecting any target."""
+        # pylint: disable=no-member
+        self.module.connectMultiDrop()  # type: ignore[attr-defined]
+
+    def add_target(self, target_sel: int) -> int:
+        """Select target over TARGETSEL and register it for fast switching.
+
+        :param target_sel: TARGETSEL value (TINSTANCE | TPARTNO | TDESIGNER | 1)
+        :return: Target handle, target is active after this call
+        """
+        # pylint: disable=no-member
+        return self.module.addTarget(target_sel & 0xFFFFFFFF)  # type: ignore[attr-defined]
+
+    def discover_targets(self, target_ids: list[int], instances: int = 16) -> list[int]:
+        """Probe all instances of given targets on multi-drop bus.
+
+        :param target_ids: TARGETID values, TREVISION is ignored
+        :param instances: Number of TINSTANCE values to probe for each TARGETID
+        :return: Handles of responding targets
+        """
+        handles: list[int] = []
+        for target_id in target_ids:
+            for instance in range(instances):
+                try:
+                    handles.append(self.add_target((instance << 28) | (target_id & 0x0FFFFFFF) | 1))
+                except RuntimeError:
+                    logger.debug(f"No response from target {target_id:08X} instance {instance}")
+        return handles
+
+    def select_target(self, handle: int) -> None:
+        """Switch active multi-drop target.
+
+        :param handle: Target handle returned by add_target or discover_targets
+        """
+        # pylint: disable=no-member
+        self.module.selectTarget(handle)  # type: ignore[attr-defined]
+
+    def get_targets(self) -> list[dict[str, Any]]:
+        """Get info about all registered multi-drop targets.
+
+        :return: List of target info dictionaries
+        """
+        targets = []
+        # pylint: disable=no-member
+        for handle in range(self.module.getTargetCount()):  # type: ignore[attr-defined]
+            info = self.module.getTargetInfo(handle)  # type: ignore[attr-defined]
+            info["targetSel"] &= 0xFFFFFFFF
+            info["dpidr"] &= 0xFFFFFFFF
+            targets.append(info)
+        return targets
+
+    def set_packet_size(self, size: int) -> int:
+        """Set packet size supported by host transport.
+
+        Requests are limited to the size supported by both host and probe, 64 bytes is used as lower bound.
+        Opened interface receives packets of negotiated size from then on.
+
+        :param size: Maximal packet size of host transport in bytes
+        :return: Negotiated packet size
+        """
+        # pylint: disable=no-member
+        packet_size: int = self.module.setPacketSize(size)  # type: ignore[attr-defined]
+        if self.interface is not None:
+            self.interface.packet_size = packet_size
+        return packet_size
+
+    def discover_components(self, target_name: str, cache_dir: Optional[str] = None) -> str:
+        """Load CoreSight component map from cache or discover it from AP list and ROM tables.
+
+        Cached map is validated against connected target, full scan is done only when it does not match.
+
+        :param target_name: Target name used in map key (see ProbeInfo.target_name)
+        :param cache_dir: Directory for serialized maps, defaults to ~/.cache/webix_dapper/components
+        :return: Serialized component map
+        """
+        # pylint: disable=no-member
+        key = self.module.componentMapKey(target_name)  # type: ignore[attr-defined]
+        if cache_dir is None:
+            cache_dir = os.path.join(os.path.expanduser("~"), ".cache", "webix_dapper", "components")
+        cache_file = os.path.join(cache_dir, re.sub(r"[^A-Za-z0-9_.-]", "_", key) + ".txt")
+
+        data = None
+        if os.path.isfile(cache_file):
+            with open(cache_file, "r", encoding="utf-8") as file:
+                data = file.read()
+            if not self.module.restoreComponents(data):  # type: ignore[attr-defined]
+                logger.info(f"Cached component map for {key} does not match target")
+                data = None
+        if data is None:
+            data = self.module.discoverComponents(target_name)  # type: ignore[attr-defined]
+            os.makedirs(cache_dir, exist_ok=True)
+            with open(cache_file, "w", encoding="utf-8") as file:
+                file.write(data)
+
+        self.mem_ap = self.module.getMemAP()  # type: ignore[attr-defined]
+        return data
+
+    def rtt_start(self, start: int, size: int, ap_sel: int = -1) -> list[dict[str, Any]]:
+        """Find RTT control block in RAM range and read its ring descriptors.
+
+        Control block found earlier is only validated. Target core keeps running, all accesses go through MEM-AP.
+
+        :param start: RAM range start address
+        :param size: RAM range size in bytes
+        :param ap_sel: MEM-AP index, AP found by discover_components is used by default
+        :return: List of up channel info dictionaries
+        """
+        # pylint: disable=no-member
+        count = self.module.rttStart(ap_sel, start, size)  # type: ignore[attr-defined]
+        return [self.module.rttGetChannelInfo(index) for index in range(count)]  # type: ignore[attr-defined]
+
+    def rtt_stop(self) -> None:
+        """Forget RTT ring descriptors, control block is searched again by next rtt_start."""
+        # pylint: disable=no-member
+        self.module.rttStop()  # type: ignore[attr-defined]
+
+    def rtt_poll(self) -> list[bytes]:
+        """Read new data from all RTT up channels.
+
+        Write offsets of all channels are polled in one transfer, only new data are read from target.
+
+        :return: New data of every up channel
+        """
+        # pylint: disable=no-member
+        self.module.rttPoll()  # type: ignore[attr-defined]
+        return [
+            bytes(self.module.rttRead(index).buffer)  # type: ignore[attr-defined]
+            for index in range(self.module.rttGetChannelCount())  # type: ignore[attr-defined]
+        ]
+
+    def profiler_start(self, ap_sel: int = -1) -> None:
+        """Enable DWT PC sampling and clear collected histogram.
+
+        :param ap_sel: MEM-AP index, AP of discovered DWT or core debug is used by default
+        """
+        # pylint: disable=no-member
+        self.module.profilerStart(ap_sel)  # type: ignore[attr-defined]
+
+    def profiler_sample(self, count: int) -> int:
+        """Read DWT PCSR count times while target is running.
+
+        All reads are sent as block transfers, so sample rate is given by packet size (see set_packet_size).
+
+        :param count: Number of samples
+        :return: Number of valid samples, PCSR is invalid while core is halted or in lockup
+        """
+        # pylint: disable=no-member
+        return self.module.profilerSample(count)  # type: ignore[attr-defined]
+
+    def profiler_stats(self) -> dict[str, int]:
+        """Get profiler statistics.
+
+        :return: Dictionary with total samples, invalid samples and unique PC count
+        """
+        # pylint: disable=no-member
+        return self.module.profilerGetStats()  # type: ignore[attr-defined]
+
+    def profiler_histogram(self) -> dict[int, int]:
+        """Get collected PC histogram.
+
+        :return: Sample count of every PC, ordered from the hottest one
+        """
+        # pylint: disable=no-member
+        data = bytes(self.module.profilerGetHistogram().buffer)  # type: ignore[attr-defined]
+        values = struct.unpack(f"<{len(data) // 4}I", data)
+        return dict(zip(values[::2], values[1::2]))
+
+    def profiler_stop(self) -> None:
+        """Restore trace enable state, collected histogram is kept."""
+        # pylint: disable=no-member
+        self.module.profilerStop()  # type: ignore[attr-defined]
+
+    def simulator_start(
+        self,
+        packet_size: int = 512,
+        wait_percent: int = 0,
+        seed: int = 1,
+        flash: tuple[int, int] = (0x00000000, 0x100000),
+        ram: tuple[int, int] = (0x20000000, 0x40000),
+        target_id: int = 0,
+        instances: int = 0,
+    ) -> None:
+        """Replace probe interface by in-process simulated CMSIS-DAP probe.
+
+        Simulated target has single AHB-AP with Cortex-M memory map, no interface needs to be opened.
+        With instances set it is multi-drop bus, only the instance picked by TARGETSEL responds.
+
+        :param packet_size: Probe packet size
+        :param wait_percent: Chance of WAIT acknowledge for every AP access attempt
+        :param seed: Seed of WAIT injection and PC samples, runs with the same seed are identical
+        :param flash: Read-only flash base address and size
+        :param ram: RAM base address and size
+        :param target_id: TARGETID of multi-drop instances
+        :param instances: Number of multi-drop instances, 0 for single drop SW-DP v1
+        """
+        # pylint: disable=no-member
+        self.module.simulatorStart(  # type: ignore[attr-defined]
+            {
+                "packetSize": packet_size,
+                "waitPercent": wait_percent,
+                "seed": seed,
+                "flashBase": flash[0],
+                "flashSize": flash[1],
+                "ramBase": ram[0],
+                "ramSize": ram[1],
+                "targetId": target_id & 0xFFFFFFFF,
+                "instances": instances,
+            }
+        )
+
+    def simulator_stop(self) -> None:
+        """Stop simulated probe, probe interface is used again."""
+        # pylint: disable=no-member
+        self.module.simulatorStop()  # type: ignore[attr-defined]
+
+    def simulator_stats(self) -> dict[str, int]:
+        """Get simulated probe statistics.
+
+        :return: Dictionary with number of packets, DP/AP accesses, injected WAITs and faults
+        """
+        # pylint: disable=no-member
+        return self.module.simulatorGetStats()  # type: ignore[attr-defined]
+
+    def add_memory_region(self, kind: str, base: int, size: int, block_size: int = 0) -> None:
+        """Describe target memory region, regions are reported to GDB as memory map.
+
+        Region type selects memory cache policy too, see memory_cache_enable.
+        Simulator sets its flash and RAM regions itself.
+
+        :param kind: One of "ram", "flash", "rom" or "peripheral"
+        :param base: Region base address
+        :param size: Region size in bytes
+        :param block_size: Flash erase block size
+        :raises ValueError: If region kind is not known
+        """
+        if kind not in MEMORY_REGION_TYPES:
+            raise ValueError(f"Unknown memory region type {kind}")
+        # pylint: disable=no-member
+        self.module.addMemoryRegion(  # type: ignore[attr-defined]
+            {
+                "type": MEMORY_REGION_TYPES.index(kind),
+                "base": base,
+                "size": size,
+                "blockSize": block_size,
+            }
+        )
+
+    def clear_memory_regions(self) -> None:
+        """Forget all memory regions."""
+        # pylint: disable=no-member
+        self.module.clearMemoryRegions()  # type: ignore[attr-defined]
+
+    @staticmethod
+    def _uint8_array(data: bytes) -> Uint8Array:
+        # embind strings are UTF-8, so binary data go to WASM module as typed array
+        return Uint8Array((ctypes.c_uint8 * len(data)).from_buffer_copy(data))
+
+    def memory_read(self, address: int, size: int, ap_sel: int = -1) -> bytes:
+        """Read target memory at any alignment, through page cache when it is enabled.
+
+        :param address: Start address
+        :param size: Number of bytes
+        :param ap_sel: MEM-AP index, AP found by discover_components is used by default
+        :return: Read bytes
+        """
+        # pylint: disable=no-member
+        return bytes(
+            self.module.memoryRead(ap_sel, address, size).buffer  # type: ignore[attr-defined]
+        )
+
+    def memory_write(self, address: int, data: bytes, ap_sel: int = -1) -> None:
+        """Write target memory at any alignment, cached pages of written range are dropped.
+
+        :param address: Start address
+        :param data: Bytes to write
+        :param ap_sel: MEM-AP index, AP found by discover_components is used by default
+        """
+        # pylint: disable=no-member
+        self.module.memoryWrite(ap_sel, address, self._uint8_array(data))  # type: ignore[attr-defined]
+
+    def memory_batch(self, ops: list[tuple[int, Union[int, bytes]]], ap_sel: int = -1) -> list[bytes]:
+        """Run scatter-gather memory operations in as few probe packets as possible.
+
+        Consecutive operations of the same direction on RAM, flash and ROM regions are sorted and their overlapping or
+        adjacent ranges merged (later write wins), reads of them may be widened to words and joined over small gaps.
+        Operations on peripherals or memory outside of regions are kept in list order and never merged, so register
+        sequences (e.g. watchdog unlock) are safe. Access size follows alignment.
+
+        :param ops: List of (address, size) reads and (address, data) writes
+        :param ap_sel: MEM-AP index, AP found by discover_components is used by default
+        :return: Data of every read operation in order
+        """
+        words: list[int] = []
+        writes: list[bytes] = []
+        sizes: list[int] = []
+        for address, item in ops:
+            if isinstance(item, int):
+                words += [0, address & 0xFFFFFFFF, item]
+                sizes.append(item)
+            else:
+                words += [1, address & 0xFFFFFFFF, len(item)]
+                writes.append(item)
+        packed = self._uint8_array(struct.pack(f"<{len(words)}I", *words))
+        # pylint: disable=no-member
+        data = bytes(
+            self.module.memoryBatch(  # type: ignore[attr-defined]
+                ap_sel, packed, self._uint8_array(b"".join(writes))
+            ).buffer
+        )
+        reads = []
+        offset = 0
+        for size in sizes:
+            reads.append(data[offset : offset + size])
+            offset += size
+        return reads
+
+    def memory_cache_enable(self, enabled: bool = True) -> None:
+        """Enable memory page cache used by memory_read and GDB server.
+
+        ROM and flash regions are cached until write or reset, RAM regions only while core stays halted and
+        peripheral or unknown memory is never cached. Raw CoreSight AP writes drop the whole cache.
+
+        :param enabled: False disables and empties the cache
+        """
+        # pylint: disable=no-member
+        self.module.memoryCacheEnable(enabled)  # type: ignore[attr-defined]
+
+    def memory_cache_invalidate(self) -> None:
+        """Drop all cached pages, e.g. after target memory was changed by other tool."""
+        # pylint: disable=no-member
+        self.module.memoryCacheInvalidate()  # type: ignore[attr-defined]
+
+    def memory_cache_stats(self) -> dict[str, int]:
+        """Get memory cache statistics.
+
+        :return: Dictionary with page hits, misses, bypassed target reads and invalidated pages
+        """
+        # pylint: disable=no-member
+        return self.module.memoryCacheGetStats()  # type: ignore[attr-defined]
+
+    def memory_cache_reset_stats(self) -> None:
+        """Zero memory cache statistics."""
+        # pylint: disable=no-member
+        self.module.memoryCacheResetStats()  # type: ignore[attr-defined]
+
+    def gdb_start(self, ap_sel: int = -1) -> None:
+        """Start GDB remote serial protocol session, target core is halted.
+
+        :param ap_sel: MEM-AP index, AP found by discover_components is used by default
+        """
+        # pylint: disable=no-member
+        self.module.gdbStart(ap_sel)  # type: ignore[attr-defined]
+
+    def gdb_receive(self, data: bytes) -> bytes:
+        """Process bytes received from GDB client, all complete packets are answered at once.
+
+        :param data: Received bytes
+        :return: Bytes to be sent to the client
+        """
+        # pylint: disable=no-member
+        reply = self.module.gdbReceive(data.decode("latin-1"))  # type: ignore[attr-defined]
+        return reply.encode("latin-1")
+
+    def gdb_poll(self) -> bytes:
+        """Check running target.
+
+        :return: Stop reply once target halts, empty while it keeps running
+        """
+        # pylint: disable=no-member
+        return self.module.gdbPoll().encode("latin-1")  # type: ignore[attr-defined]
+
+    def gdb_running(self) -> bool:
+        """Check whether GDB session waits for running target to halt.
+
+        :return: True when gdb_poll should be called periodically
+        """
+        # pylint: disable=no-member
+        return bool(self.module.gdbRunning())  # type: ignore[attr-defined]
+
+    def gdb_detached(self) -> bool:
+        """Check whether GDB client detached or killed the session.
+
+        :return: True when connection should be closed
+        """
+        # pylint: disable=no-member
+        return bool(self.module.gdbDetached())  # type: ignore[attr-defined]
+
+    def gdb_stop(self) -> None:
+        """End GDB session."""
+        # pylint: disable=no-member
+        self.module.gdbStop()  # type: ignore[attr-defined]
+
 
 class DapperFactory:
     """Factory class for creating and managing WebixDapper instances.
@@ -405,12 +881,16 @@ class DapperFactory:
     :param _instance: Singleton instance of DapperFactory
     :param _dapper: WebixDapper instance
     :param probes: List of available probes
+    :param transports: Interfaces of each listed probe keyed by serial number, ordered by priority
+    :param select_transport: Pick the fastest transport by TransportSelector when probe is created
     :param path: Path to WASM file
     """
 
     _instance: Optional["DapperFactory"] = None
     _dapper: Optional[WebixDapper] = None
     probes: list[Interface] = []
+    transports: dict[str, list[Interface]] = {}
+    select_transport: bool = True
     path: Optional[str] = None
 
     def __init__(self) -> None:
@@ -453,36 +933,75 @@ class DapperFactory:
     def list_probes(cls) -> list[Interface]:
         """List all available probes.
 
+        Only USB descriptors are used, DAP details are fetched on demand by probe_info(). Probe
+        exposing more interfaces is listed once, by transport already selected for it or by
+        interface priority.
+
         :return: List of available probes
         """
         interfaces = InterfaceFactory.load_interfaces()
-        probes: list[Interface] = []
+        transports: dict[str, list[Interface]] = {}
         for interface in interfaces:
             for probe in interface.list_probes():
-                if probe.serial_no not in {known_probe.serial_no for known_probe in probes}:
-                    probes.append(probe)
+                candidates = transports.setdefault(probe.serial_no, [])
+                if all(candidate.type != probe.type for candidate in candidates):
+                    candidates.append(probe)
 
-        DapperFactory.probes = probes
-        return probes
+        DapperFactory.transports = transports
+        DapperFactory.probes = [TransportSelector.preferred(c) for c in transports.values()]
+        return DapperFactory.probes
+
+    @staticmethod
+    def _find_probe(probe: Union[Interface, str]) -> Optional[Interface]:
+        if isinstance(probe, str):
+            for prb in DapperFactory.probes:
+                if prb.serial_no == probe:
+                    return prb
+            return None
+        if isinstance(probe, Interface):
+            return probe
+        raise RuntimeError("Not supported probe type detected")
 
     @classmethod
     def create_probe(cls, probe: Union[Interface, str]) -> WebixDapper:
         """Create probe instance.
 
+        Listed probe with more interfaces is opened over the fastest one (see select_transport).
+
         :param probe: Probe interface or serial number
         :return: WebixDapper instance
         :raises RuntimeError: If probe type is not supported
         """
+        probe_iface = cls._find_probe(probe)
+        if probe_iface is not None and cls.select_transport:
+            candidates = cls.transports.get(probe_iface.serial_no, [])
+            if probe_iface in candidates:
+                probe_iface = TransportSelector.select(candidates)
         dapper = cls.instance().dapper()
-        probe_iface = None
-        if isinstance(probe, str):
-            for prb in DapperFactory.probes:
-                if prb.serial_no == probe:
-                    probe_iface = prb
-        elif isinstance(probe, Interface):
-            probe_iface = probe
-        else:
-            raise RuntimeError("Not supported probe type detected")
-
         dapper.open(probe_iface)
         return dapper
+
+    @classmethod
+    def probe_info(cls, probe: Union[Interface, str]) -> ProbeInfo:
+        """Get DAP info of listed probe, probe is opened only when its info is not cached yet.
+
+        Probe is queried by its own temporary WebixDapper, so session of dapper() is left untouched.
+
+        :param probe: Probe interface or serial number
+        :return: ProbeInfo object containing DAP information
+        :raises RuntimeError: If probe is not listed
+        """
+        probe_iface = cls._find_probe(probe)
+        if probe_iface is None:
+            raise RuntimeError("Probe is undefined.")
+        info = WebixDapper.probe_info_cache.get(probe_iface.serial_no)
+        if info is None:
+            dapper = WebixDapper(cls.instance().path)
+            dapper.init()
+            dapper.interface = probe_iface
+            probe_iface.open()
+            try:
+                info = dapper.get_probe_dap_info()
+            finally:
+                dapper.close()
+        return info
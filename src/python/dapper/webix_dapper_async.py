@@ -0,0 +1,185 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# Copyright 2025 Oidis
+#
+# SPDX-License-Identifier: BSD-3-Clause
+
+"""This module provides asyncio session API over WebixDapper.
+
+WASM runtime and USB transfers are blocking, so every session owns single worker thread where all calls of its probe
+are executed in order. Event loop is never blocked by probe communication and one process can serve many probes.
+CoreSight accesses issued by independent tasks are coalesced into shared DAP transfers while the probe is busy.
+Dependent accesses (e.g. MEM-AP TAR write followed by DRW access) have to be issued by core_sight_transaction, so
+accesses of other tasks are never placed in between.
+"""
+
+import asyncio
+import threading
+from concurrent.futures import ThreadPoolExecutor
+from functools import partial
+from typing import Any, Callable, Optional, TypeVar
+
+from .webix_dapper import POWER_ACK_MASK, ProbeInfo, WebixDapper
+
+T = TypeVar("T")
+
+
+class _CoreSightBatch:
+    """CoreSight accesses waiting for probe worker."""
+
+    def __init__(self) -> None:
+        self.ops: list[tuple[bool, bool, int, int]] = []
+        self.futures: list[tuple[asyncio.Future, int, int]] = []  # future, first op index, op count
+        self.started = False
+
+
+class AsyncWebixDapper:
+    """Asyncio session over WebixDapper instance.
+
+    :param dapper: Opened WebixDapper instance, it should not be used directly while session is active
+    :param max_batch: Maximal number of CoreSight accesses sent to WASM module at once
+    """
+
+    def __init__(self, dapper: WebixDapper, max_batch: int = 256) -> None:
+        """Initialize AsyncWebixDapper instance.
+
+        :param dapper: Opened WebixDapper instance
+        :param max_batch: Maximal number of CoreSight accesses sent to WASM module at once
+        """
+        self.dapper = dapper
+        self.max_batch = max_batch
+        self._executor = ThreadPoolExecutor(max_workers=1, thread_name_prefix="dapper")
+        self._lock = threading.Lock()
+        self._batch: Optional[_CoreSightBatch] = None
+
+    async def __aenter__(self) -> "AsyncWebixDapper":
+        """Enter the async context manager.
+
+        :return: Session instance
+        """
+        return self
+
+    async def __aexit__(self, exc_type: Any, exc_val: Any, exc_tb: Any) -> None:
+        """Exit the async context manager and close the session.
+
+        :param exc_type: Exception type
+        :param exc_val: Exception value
+        :param exc_tb: Exception traceback
+        """
+        await self.close()
+
+    async def call(self, function: Callable[..., T], *args: Any) -> T:
+        """Run blocking call in probe worker after all previously issued operations.
+
+        :param function: Callable using WebixDapper instance of this session
+        :param args: Arguments of the callable
+        :return: Value returned by the callable
+        """
+        with self._lock:
+            # accesses issued after this call must not be sent before it
+            self._batch = None
+        return await asyncio.get_running_loop().run_in_executor(
+            self._executor, partial(function, *args)
+        )
+
+    async def close(self) -> None:
+        """Close probe interface and stop worker of this session."""
+        await self.call(self.dapper.close)
+        self._executor.shutdown(wait=False)
+
+    async def get_probe_dap_info(self, refresh: bool = False) -> ProbeInfo:
+        """Get probe DAP information.
+
+        :param refresh: Query probe even if info is already cached
+        :return: ProbeInfo object containing DAP information
+        """
+        return await self.call(self.dapper.get_probe_dap_info, refresh)
+
+    async def reset(self) -> None:
+        """Reset the device."""
+        await self.call(self.dapper.reset)
+
+    async def connect(self) -> None:
+        """Connect to the device and control power."""
+        # pylint: disable=no-member
+        await self.call(self.dapper.module.connect)  # type: ignore[attr-defined]
+        await self.power_control(True)
+        self.dapper.stdout_handler("System Power True")
+        await self.power_control(False)
+        self.dapper.stdout_handler("Debug Power True")
+
+    async def power_control(self, sys_power: bool) -> None:
+        """Control device power, acknowledge is polled without blocking the event loop.
+
+        :param sys_power: True for system power, False for debug power
+        :raises RuntimeError: If failed to control device power
+        """
+        req, check_status = WebixDapper.power_control_request(sys_power)
+        await self.core_sight_write(False, 0x04, req)
+        for _ in range(11):
+            await asyncio.sleep(0.1)
+            if (await self.core_sight_read(False, 0x04) & POWER_ACK_MASK) == check_status:
+                return
+        raise RuntimeError("Failed to control device power")
+
+    async def core_sight_read(self, access_port: bool, address: int) -> int:
+        """Read from CoreSight.
+
+        :param access_port: True for access port, False for debug port
+        :param address: Address to read from
+        :return: Read value
+        """
+        return (await self._core_sight([(access_port, True, address, 0)]))[0]
+
+    async def core_sight_write(self, access_port: bool, address: int, data: int) -> None:
+        """Write to CoreSight.
+
+        :param access_port: True for access port, False for debug port
+        :param address: Address to write to
+        :param data: Data to write
+        """
+        await self._core_sight([(access_port, False, address, data)])
+
+    async def core_sight_transaction(self, ops: list[tuple[bool, bool, int, int]]) -> list[int]:
+        """Run CoreSight accesses as one unit, accesses of other tasks are never placed in between.
+
+        Transaction is still coalesced with other accesses, but it is never split between batches.
+
+        :param ops: Accesses as (access_port, read, address, data) tuples, data is ignored by reads
+        :return: Read values (written data for writes) in order of ops
+        """
+        return await self._core_sight(list(ops))
+
+    async def _core_sight(self, ops: list[tuple[bool, bool, int, int]]) -> list[int]:
+        loop = asyncio.get_running_loop()
+        future = loop.create_future()
+        with self._lock:
+            batch = self._batch
+            submit = (
+                batch is None or batch.started or len(batch.ops) + len(ops) > self.max_batch
+            )
+            if batch is None or submit:
+                batch = _CoreSightBatch()
+                self._batch = batch
+            batch.futures.append((future, len(batch.ops), len(ops)))
+            batch.ops.extend(ops)
+        if submit:
+            result = loop.run_in_executor(self._executor, self._run_batch, batch)
+            result.add_done_callback(partial(self._resolve_batch, batch))
+        return await future
+
+    def _run_batch(self, batch: _CoreSightBatch) -> list[int]:
+        with self._lock:
+            batch.started = True
+        return self.dapper.core_sight_batch(batch.ops)
+
+    @staticmethod
+    def _resolve_batch(batch: _CoreSightBatch, result: asyncio.Future) -> None:
+        for future, start, count in batch.futures:
+            if future.done():
+                continue
+            if result.exception() is not None:
+                future.set_exception(result.exception())  # type: ignore[arg-type]
+            else:
+                future.set_result(result.result()[start : start + count])
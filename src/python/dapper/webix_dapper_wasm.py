@@ -7,10 +7,13 @@
 # SPDX-License-Identifier: BSD-3-Clause
 
 import ctypes
+import hashlib
 import logging
 import os
 import sys
 import types
+from functools import partial
+from importlib import metadata
 from time import sleep
 from typing import Any, Callable, Optional, Tuple, Union, cast
 
@@ -43,6 +46,19 @@ if not logger.handlers:
     logger.addHandler(handler)
 
 
+class WasmCppException(RuntimeError):
+    """C++ exception thrown by wasm code, carries pointer to the thrown object."""
+
+    def __init__(self, message: str, exc_ptr: int) -> None:
+        """Initialize WasmCppException.
+
+        :param message: Exception message (what() or type name)
+        :param exc_ptr: Pointer to the thrown object in WASM memory
+        """
+        super().__init__(message)
+        self.exc_ptr = exc_ptr
+
+
 class WasmExceptionInfo:
     """Represents information about a WebAssembly exception."""
 
@@ -76,6 +92,36 @@ class WasmExceptionInfo:
             self.memory.read(self.store, self.ptr + 8, self.ptr + 8 + 4), "little"
         )
 
+    def get_caught(self) -> bool:
+        """Get whether the exception has been caught.
+
+        :return: True if the exception was caught
+        """
+        return self.memory.read(self.store, self.ptr + 12, self.ptr + 13)[0] != 0
+
+    def get_rethrown(self) -> bool:
+        """Get whether the exception has been rethrown.
+
+        :return: True if the exception was rethrown
+        """
+        return self.memory.read(self.store, self.ptr + 13, self.ptr + 14)[0] != 0
+
+    def set_rethrown(self, rethrown: bool) -> None:
+        """Set whether the exception has been rethrown.
+
+        :param rethrown: Boolean indicating if the exception was rethrown
+        """
+        self.memory.write(self.store, bytes([1 if rethrown else 0]), self.ptr + 13)
+
+    def get_adjusted_ptr(self) -> int:
+        """Get the adjusted pointer value.
+
+        :return: Integer representing the adjusted pointer value
+        """
+        return int.from_bytes(
+            self.memory.read(self.store, self.ptr + 16, self.ptr + 16 + 4), "little"
+        )
+
     def set_caught(self, caught: bool) -> None:
         """Set whether the exception has been caught.
 
@@ -116,15 +162,151 @@ class WasmExceptionInfo:
         self.set_destructor(destructor)
 
 
-class WebixDapperWasm:
-    def __init__(self, context_path: Optional[str] = None) -> None:
-        self.trace = False
-        self.with_stack_control = False
+_engine: Optional[Engine] = None
+_modules: dict[tuple, Module] = {}
+
+
+def shared_engine() -> Engine:
+    """Get engine shared by all module instances of the process.
+
+    :return: Engine configured for optimized cranelift code
+    """
+    global _engine  # pylint: disable=global-statement
+    if _engine is None:
         config = Config()
         config.cranelift_opt_level = "speed"
         config.strategy = "cranelift"
-        engine = Engine(config)
-        self.store = Store(engine)
+        _engine = Engine(config)
+    return _engine
+
+
+def load_module(engine: Engine, path: str, cache_dir: Optional[str] = None) -> Module:
+    """Load WASM module, natively compiled code is reused from previous runs.
+
+    Cache key is derived from the binary and wasmtime version, so rebuilt modules or upgraded runtime never hit
+    stale entries. Entries compiled for different engine config are rejected by wasmtime and compiled again.
+    Loaded module is also kept in memory, next load of unchanged binary in the same process is free.
+
+    :param engine: Engine to compile the module for
+    :param path: Path to WASM binary
+    :param cache_dir: Directory for compiled modules, defaults to WEBIX_DAPPER_CACHE environment variable or
+        ~/.cache/webix_dapper/modules, empty disables cache
+    :return: Compiled module
+    """
+    if cache_dir is None:
+        cache_dir = os.environ.get("WEBIX_DAPPER_CACHE")
+    stat = os.stat(path)
+    key = (engine, os.path.abspath(path), stat.st_mtime_ns, stat.st_size, cache_dir)
+    if (module := _modules.get(key)) is None:
+        module = _modules[key] = _load_module(engine, path, cache_dir)
+    return module
+
+
+def _load_module(engine: Engine, path: str, cache_dir: Optional[str]) -> Module:
+    with open(path, "rb") as file:
+        wasm = file.read()
+    if cache_dir == "":
+        return Module(engine, wasm)
+    if cache_dir is None:
+        cache_dir = os.path.join(os.path.expanduser("~"), ".cache", "webix_dapper", "modules")
+    try:
+        version = metadata.version("wasmtime")
+    except metadata.PackageNotFoundError:
+        version = "unknown"
+    cache_file = os.path.join(cache_dir, hashlib.sha256(wasm + version.encode()).hexdigest() + ".cwasm")
+
+    if os.path.isfile(cache_file):
+        try:
+            return Module.deserialize_file(engine, cache_file)
+        except Exception as e:  # pylint: disable=broad-except
+            logger.debug(f"compiled module {cache_file} rejected: {e}")
+    module = Module(engine, wasm)
+    try:
+        os.makedirs(cache_dir, exist_ok=True)
+        tmp_file = f"{cache_file}.{os.getpid()}"
+        with open(tmp_file, "wb") as file:
+            file.write(module.serialize())
+        os.replace(tmp_file, cache_file)
+    except OSError as e:
+        logger.debug(f"compiled module not cached: {e}")
+    return module
+
+
+_factories: dict[str, Callable] = {}
+
+
+def generated_factory(name: str, source: str) -> Callable:
+    """Compile generated factory function once per process.
+
+    :param name: Factory name, used also as cache key
+    :param source: Python source defining function of the same name
+    :return: Factory function
+    """
+    if (factory := _factories.get(name)) is None:
+        scope: dict[str, Any] = {"WasmCppException": WasmCppException}
+        exec(compile(source, f"<{name}>", "exec"), scope)  # pylint: disable=exec-used
+        factory = _factories[name] = scope[name]
+    return factory
+
+
+def invoker_factory(arg_count: int, returns: bool) -> Callable:
+    """Get factory for embind function callers of given arity.
+
+    Created caller takes exact number of positional arguments and has all wire converters bound as locals.
+
+    :param arg_count: Number of function arguments
+    :param returns: True if the function has non-void return type
+    :return: Factory(invoker, fn, from_wire, *to_wire) returning the caller
+    """
+    name = f"make_invoker_{arg_count}{'r' if returns else 'v'}"
+    args = ", ".join(f"a{i}" for i in range(arg_count))
+    wires = "".join(f", w{i}" for i in range(arg_count))
+    call = "invoker(fn" + "".join(f", w{i}(None, a{i})" for i in range(arg_count)) + ")"
+    source = (
+        f"def {name}(invoker, fn, from_wire{wires}):\n"
+        f"    def call({args}):\n"
+        f"        {'return from_wire(' + call + ')' if returns else call}\n"
+        f"    return call\n"
+    )
+    return generated_factory(name, source)
+
+
+def invoke_factory(sig: str) -> Callable:
+    """Get factory for invoke_* trampoline of given dynCall signature.
+
+    C++ exception is turned into setThrew() and returned back to wasm landing pad as JS runtime does, any other
+    exception propagates to the caller. Matching dynCall export is resolved on first call.
+
+    :param sig: Emscripten signature, e.g. "vii"
+    :return: Factory(runtime) returning the trampoline
+    """
+    name = f"make_invoke_{sig}"
+    args = "".join(f", a{i}" for i in range(len(sig) - 1))
+    fallback = {"v": "", "f": " 0.0", "d": " 0.0"}.get(sig[0], " 0")
+    source = (
+        f"def {name}(runtime):\n"
+        f"    dyn_call = None\n"
+        f"    def invoke(index{args}):\n"
+        f"        nonlocal dyn_call\n"
+        f"        if dyn_call is None:\n"
+        f"            dyn_call = runtime.dyn_call_export('{sig}')\n"
+        f"        sp = runtime.invoke_stack_save()\n"
+        f"        try:\n"
+        f"            return dyn_call(runtime.store, index{args})\n"
+        f"        except WasmCppException:\n"
+        f"            runtime.invoke_stack_restore(sp)\n"
+        f"            runtime.set_threw(1, 0)\n"
+        f"            return{fallback}\n"
+        f"    return invoke\n"
+    )
+    return generated_factory(name, source)
+
+
+class WebixDapperWasm:
+    def __init__(self, context_path: Optional[str] = None, cache_dir: Optional[str] = None) -> None:
+        self.trace = False
+        self.with_stack_control = False
+        self.store = Store(shared_engine())
         memory = Memory(
             self.store, MemoryType(limits=Limits(min=1, max=int(2147483648 / (64 * 1024))))
         )
@@ -135,7 +317,13 @@ class WebixDapperWasm:
             context_path = os.path.abspath(
                 os.path.join(os.path.dirname(__file__), "webix-dapper-wasm.wasm")
             )
-        self.module = Module.from_file(self.linker.engine, context_path)
+        self.module = load_module(self.linker.engine, context_path, cache_dir)
+        self.dyn_calls: dict[str, Callable[..., Any]] = {}
+        self.exception_last = 0
+        self.exceptions_caught: list[WasmExceptionInfo] = []
+        self.uncaught_exceptions = 0
+        self.host_read_data: Optional[Callable[[], Uint8Array]] = None
+        self.host_write_data: Optional[Callable[[Uint8Array], None]] = None
 
         self.instance = Instance(self.store, self.module, self.construct_imports())
         self.exports: dict[str, Callable[..., Any]] = cast(
@@ -182,54 +370,7 @@ class WebixDapperWasm:
 
         self._stack_save = self.create_export_wrapper("stackSave")
         self._stack_restore = self.create_export_wrapper("stackRestore")
-        self.dynCall_ii = self.create_export_wrapper("dynCall_ii")
-        self.dynCall_iiii = self.create_export_wrapper("dynCall_iiii")
-        self.dynCall_iii = self.create_export_wrapper("dynCall_iii")
-        self.dynCall_vi = self.create_export_wrapper("dynCall_vi")
-        self.dynCall_vii = self.create_export_wrapper("dynCall_vii")
-        self.dynCall_viii = self.create_export_wrapper("dynCall_viii")
-        self.dynCall_diiii = self.create_export_wrapper("dynCall_diiii")
-        self.dynCall_vid = self.create_export_wrapper("dynCall_vid")
-        self.dynCall_viiiii = self.create_export_wrapper("dynCall_viiiii")
-        self.dynCall_v = self.create_export_wrapper("dynCall_v")
-        self.dynCall_i = self.create_export_wrapper("dynCall_i")
-        self.dynCall_id = self.create_export_wrapper("dynCall_id")
-        self.dynCall_f = self.create_export_wrapper("dynCall_f")
-        self.dynCall_ff = self.create_export_wrapper("dynCall_ff")
-        self.dynCall_viiiiii = self.create_export_wrapper("dynCall_viiiiii")
-        self.dynCall_fii = self.create_export_wrapper("dynCall_fii")
-        self.dynCall_viif = self.create_export_wrapper("dynCall_viif")
-        self.dynCall_fi = self.create_export_wrapper("dynCall_fi")
-        self.dynCall_fif = self.create_export_wrapper("dynCall_fif")
-        self.dynCall_jiji = self.create_export_wrapper("dynCall_jiji")
-        self.dynCall_iidiiii = self.create_export_wrapper("dynCall_iidiiii")
-        self.dynCall_viijii = self.create_export_wrapper("dynCall_viijii")
-        self.dynCall_viiii = self.create_export_wrapper("dynCall_viiii")
-        self.dynCall_iiiiiiii = self.create_export_wrapper("dynCall_iiiiiiii")
-        self.dynCall_iiiiiiiiiii = self.create_export_wrapper("dynCall_iiiiiiiiiii")
-        self.dynCall_iiiii = self.create_export_wrapper("dynCall_iiiii")
-        self.dynCall_jiiii: Callable[..., Any] = self.create_export_wrapper("dynCall_jiiii")
-        self.dynCall_iiiiiiiiiiiii = self.create_export_wrapper("dynCall_iiiiiiiiiiiii")
-        self.dynCall_fiii = self.create_export_wrapper("dynCall_fiii")
-        self.dynCall_diii = self.create_export_wrapper("dynCall_diii")
-        self.dynCall_viiiiiii = self.create_export_wrapper("dynCall_viiiiiii")
-        self.dynCall_iiiiiii = self.create_export_wrapper("dynCall_iiiiiii")
-        self.dynCall_iiiiiiiiiiii = self.create_export_wrapper("dynCall_iiiiiiiiiiii")
-        self.dynCall_viiiiiiii = self.create_export_wrapper("dynCall_viiiiiiii")
-        self.dynCall_viiiiiiiii = self.create_export_wrapper("dynCall_viiiiiiiii")
-        self.dynCall_viiiiiiiiii = self.create_export_wrapper("dynCall_viiiiiiiiii")
-        self.dynCall_viiiiiiiiiii = self.create_export_wrapper("dynCall_viiiiiiiiiii")
-        self.dynCall_viiiiiiiiiiii = self.create_export_wrapper("dynCall_viiiiiiiiiiii")
-        self.dynCall_viiiiiiiiiiiii = self.create_export_wrapper("dynCall_viiiiiiiiiiiii")
-        self.dynCall_viiiiiiiiiiiiii = self.create_export_wrapper("dynCall_viiiiiiiiiiiiii")
-        self.dynCall_viiiiiiiiiiiiiii = self.create_export_wrapper("dynCall_viiiiiiiiiiiiiii")
-        self.dynCall_iiiiii = self.create_export_wrapper("dynCall_iiiiii")
-        self.dynCall_iiiiiiiii = self.create_export_wrapper("dynCall_iiiiiiiii")
-        self.dynCall_iiiiiiiiii = self.create_export_wrapper("dynCall_iiiiiiiiii")
-        self.dynCall_iiiiij = self.create_export_wrapper("dynCall_iiiiij")
-        self.dynCall_iiiiid = self.create_export_wrapper("dynCall_iiiiid")
-        self.dynCall_iiiiijj = self.create_export_wrapper("dynCall_iiiiijj")
-        self.dynCall_iiiiiijj = self.create_export_wrapper("dynCall_iiiiiijj")
+        self._tempret_set = self.export_or_none("_emscripten_tempret_set")
 
     def __getitem__(self, item: str) -> Any:
         if item == "HEAPU8":
@@ -301,6 +442,29 @@ class WebixDapperWasm:
         self.exports["__wasm_call_ctors"](self.store)
         self.init_emval()
 
+    def export_or_none(self, name: str) -> Optional[Callable[..., Any]]:
+        try:
+            return self.exports[name]
+        except KeyError:
+            return None
+
+    def direct_export(self, name: str) -> Optional[Callable[..., Any]]:
+        """Get typed export bound to the store, it is called without any embind wiring.
+
+        :param name: Export name
+        :return: Callable taking raw wasm arguments or None if module does not export it
+        """
+        if (export := self.export_or_none(name)) is None:
+            return None
+        return partial(export, self.store)
+
+    def dyn_call_export(self, sig: str) -> Callable[..., Any]:
+        if (dyn_call := self.dyn_calls.get(sig)) is None:
+            if (dyn_call := self.export_or_none(f"dynCall_{sig}")) is None:
+                raise RuntimeError(f"dynCall_{sig} is not defined, bad function pointer")
+            self.dyn_calls[sig] = dyn_call
+        return dyn_call
+
     def create_export_wrapper(self, name: str) -> Callable[..., Any]:
         if name in self.exports:
             f = self.exports[name]
@@ -317,464 +481,11 @@ class WebixDapperWasm:
     def invoke_dyn(self, name: str, *args: Tuple[Any, ...]) -> Any:
         return getattr(self, name)(*args)
 
-    def invoke_jiiii(self, index: int, a1: int, a2: int, a3: int, a4: int) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_jiiii(self.store, index, a1, a2, a3, a4)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_diii(self, index: int, a1: int, a2: int, a3: int) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_diii(self.store, index, a1, a2, a3)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_fiii(self, index: int, a1: int, a2: int, a3: int) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_fiii(self.store, index, a1, a2, a3)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_v(self, index: int) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_v(self.store, index)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_vi(self, index: int, a1: int) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_vi(self.store, index, a1)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_vii(self, index: int, a1: int, a2: int) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_vii(self.store, index, a1, a2)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_viii(self, index: int, a1: int, a2: int, a3: int) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_viii(self.store, index, a1, a2, a3)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_viiii(self, index: int, a1: int, a2: int, a3: int, a4: int) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_viiii(self.store, index, a1, a2, a3, a4)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_viiiii(self, index: int, a1: int, a2: int, a3: int, a4: int, a5: int) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_viiiii(self.store, index, a1, a2, a3, a4, a5)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_viiiiii(
-        self, index: int, a1: int, a2: int, a3: int, a4: int, a5: int, a6: int
-    ) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_viiiiii(self.store, index, a1, a2, a3, a4, a5, a6)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_viiiiiii(
-        self, index: int, a1: int, a2: int, a3: int, a4: int, a5: int, a6: int, a7: int
-    ) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_viiiiiii(self.store, index, a1, a2, a3, a4, a5, a6, a7)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_viiiiiiii(
-        self, index: int, a1: int, a2: int, a3: int, a4: int, a5: int, a6: int, a7: int, a8: int
-    ) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_viiiiiiii(self.store, index, a1, a2, a3, a4, a5, a6, a7, a8)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_viiiiiiiii(
-        self,
-        index: int,
-        a1: int,
-        a2: int,
-        a3: int,
-        a4: int,
-        a5: int,
-        a6: int,
-        a7: int,
-        a8: int,
-        a9: int,
-    ) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_viiiiiiiii(self.store, index, a1, a2, a3, a4, a5, a6, a7, a8, a9)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_viiiiiiiiii(
-        self,
-        index: int,
-        a1: int,
-        a2: int,
-        a3: int,
-        a4: int,
-        a5: int,
-        a6: int,
-        a7: int,
-        a8: int,
-        a9: int,
-        a10: int,
-    ) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_viiiiiiiiii(self.store, index, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_viiiiiiiiiii(
-        self,
-        index: int,
-        a1: int,
-        a2: int,
-        a3: int,
-        a4: int,
-        a5: int,
-        a6: int,
-        a7: int,
-        a8: int,
-        a9: int,
-        a10: int,
-        a11: int,
-    ) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_viiiiiiiiiii(
-                self.store, index, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11
-            )
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_viiiiiiiiiiii(
-        self,
-        index: int,
-        a1: int,
-        a2: int,
-        a3: int,
-        a4: int,
-        a5: int,
-        a6: int,
-        a7: int,
-        a8: int,
-        a9: int,
-        a10: int,
-        a11: int,
-        a12: int,
-    ) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_viiiiiiiiiiii(
-                self.store, index, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12
-            )
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_viiiiiiiiiiiii(
-        self,
-        index: int,
-        a1: int,
-        a2: int,
-        a3: int,
-        a4: int,
-        a5: int,
-        a6: int,
-        a7: int,
-        a8: int,
-        a9: int,
-        a10: int,
-        a11: int,
-        a12: int,
-        a13: int,
-    ) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_viiiiiiiiiiiii(
-                self.store, index, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13
-            )
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_viiiiiiiiiiiiii(
-        self,
-        index: int,
-        a1: int,
-        a2: int,
-        a3: int,
-        a4: int,
-        a5: int,
-        a6: int,
-        a7: int,
-        a8: int,
-        a9: int,
-        a10: int,
-        a11: int,
-        a12: int,
-        a13: int,
-        a14: int,
-    ) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_viiiiiiiiiiiiii(
-                self.store, index, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14
-            )
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_viiiiiiiiiiiiiii(
-        self,
-        index: int,
-        a1: int,
-        a2: int,
-        a3: int,
-        a4: int,
-        a5: int,
-        a6: int,
-        a7: int,
-        a8: int,
-        a9: int,
-        a10: int,
-        a11: int,
-        a12: int,
-        a13: int,
-        a14: int,
-        a15: int,
-    ) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_viiiiiiiiiiiiiii(
-                self.store, index, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15
-            )
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_vid(self, index: int, a1: int, a2: int) -> None:
-        sp = self.stack_save()
-        try:
-            self.dynCall_vid(self.store, index, a1, a2)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_i(self, index: int) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_i(self.store, index)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_ii(self, index: int, a1: int) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_ii(self.store, index, a1)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_iii(self, index: int, a1: int, a2: int) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_iii(self.store, index, a1, a2)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_iiii(self, index: int, a1: int, a2: int, a3: int) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_iiii(self.store, index, a1, a2, a3)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_iiiii(self, index: int, a1: int, a2: int, a3: int, a4: int) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_iiiii(self.store, index, a1, a2, a3, a4)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_iiiiii(self, index: int, a1: int, a2: int, a3: int, a4: int, a5: int) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_iiiiii(self.store, index, a1, a2, a3, a4, a5)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_iiiiiii(
-        self, index: int, a1: int, a2: int, a3: int, a4: int, a5: int, a6: int
-    ) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_iiiiiii(self.store, index, a1, a2, a3, a4, a5, a6)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_iiiiiiii(
-        self, index: int, a1: int, a2: int, a3: int, a4: int, a5: int, a6: int, a7: int
-    ) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_iiiiiiii(self.store, index, a1, a2, a3, a4, a5, a6, a7)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_iiiiiiiii(
-        self, index: int, a1: int, a2: int, a3: int, a4: int, a5: int, a6: int, a7: int, a8: int
-    ) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_iiiiiiiii(self.store, index, a1, a2, a3, a4, a5, a6, a7, a8)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_iiiiiiiiii(
-        self,
-        index: int,
-        a1: int,
-        a2: int,
-        a3: int,
-        a4: int,
-        a5: int,
-        a6: int,
-        a7: int,
-        a8: int,
-        a9: int,
-    ) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_iiiiiiiiii(self.store, index, a1, a2, a3, a4, a5, a6, a7, a8, a9)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_iiiiiiiiiii(
-        self,
-        index: int,
-        a1: int,
-        a2: int,
-        a3: int,
-        a4: int,
-        a5: int,
-        a6: int,
-        a7: int,
-        a8: int,
-        a9: int,
-        a10: int,
-    ) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_iiiiiiiiiii(
-                self.store, index, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10
-            )
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_iiiiiiiiiiii(
-        self,
-        index: int,
-        a1: int,
-        a2: int,
-        a3: int,
-        a4: int,
-        a5: int,
-        a6: int,
-        a7: int,
-        a8: int,
-        a9: int,
-        a10: int,
-        a11: int,
-    ) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_iiiiiiiiiiii(
-                self.store, index, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11
-            )
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
+    def invoke_stack_save(self) -> int:
+        return self._stack_save(self.store) or 0
 
-    def invoke_iiiiiiiiiiiii(
-        self,
-        index: int,
-        a1: int,
-        a2: int,
-        a3: int,
-        a4: int,
-        a5: int,
-        a6: int,
-        a7: int,
-        a8: int,
-        a9: int,
-        a10: int,
-        a11: int,
-        a12: int,
-    ) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_iiiiiiiiiiiii(
-                self.store, index, a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12
-            )
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
-
-    def invoke_id(self, index: int, a1: int) -> Any:
-        sp = self.stack_save()
-        try:
-            return self.dynCall_id(self.store, index, a1)
-        except RuntimeError as e:
-            self.stack_restore(sp)
-            raise e
+    def invoke_stack_restore(self, stack: int) -> None:
+        self._stack_restore(self.store, stack)
 
     def environ_sizes_get(self, penviron_count: int, penviron_buf_size: int) -> int:
         logger.debug(f"environ_sizes_get {penviron_count}, {penviron_buf_size}")
@@ -814,14 +525,13 @@ class WebixDapperWasm:
         logger.warning("fd_close called")
 
     def dynCall(self, sig: str, ptr: int, *args: Tuple[Any, ...]) -> Any:
-        if args is None:
-            args = []
-        if not any(f"dynCall_{sig}" in item.name for item in self.module.exports):
-            raise RuntimeError(f'{"dynCall_" + sig} is not defined, bad function pointer')
-        return getattr(self, f"dynCall_{sig}")(self.store, ptr, *args)
+        return self.dyn_call_export(sig)(self.store, ptr, *args)
 
     def dynCaller(self, sig: str, ptr: int) -> Callable[..., Any]:
-        return lambda *args: self.dynCall(sig, ptr, *args)
+        try:
+            return partial(self.dyn_call_export(sig), self.store, ptr)
+        except RuntimeError:
+            return lambda *args: self.dynCall(sig, ptr, *args)
 
     def read_latin_1_string(self, ptr: int, max_bytes: int = -1) -> str:
         chars = []
@@ -922,103 +632,19 @@ class WebixDapperWasm:
         is_async: int,
     ) -> Callable:
         # pylint: disable=unused-argument
-        if (arg_count := len(arg_types)) < 2:
+        if len(arg_types) < 2:
             raise RuntimeError("argTypes array size mismatch")
-        is_class_method_func = arg_types[1] is not None and class_type is not None
-        needs_destructor_stack = False  # TBD
         returns = arg_types[0]["name"] != "void"
-        closure_args = [
-            human_name,
-            lambda: print("BINDING ERROR"),
-            cpp_invoker_func,
-            cpp_target_func,
-            self.run_destructors,
-            arg_types[0],
-            arg_types[1],
-        ]
-        for i in range(arg_count - 2):
-            closure_args.append(arg_types[i + 2])
-
-        closure_args.append({"iam": "ASYNCIFY"})
-
-        if not needs_destructor_stack:
-            for i in range(1 if is_class_method_func else 2, len(arg_types)):
-                if arg_types[i]["destructorFunction"] is not None:
-                    closure_args.append(arg_types[i]["destructorFunction"])
-
-        def executor0(
-            invoker: Callable = cpp_invoker_func,
-            invoke_fcn: int = cpp_target_func,
-            f_args: list[Any] = arg_types,
-            is_r: bool = returns,
-        ) -> Any:
-            rv = invoker(invoke_fcn)
-            if is_r:
-                ret = f_args[0]["fromWireType"](rv)
-                return ret
-            return None
-
-        def executor1(
-            arg0: Any,
-            invoker: Callable = cpp_invoker_func,
-            invoke_fcn: int = cpp_target_func,
-            f_args: list[Any] = arg_types,
-            is_r: bool = returns,
-        ) -> Any:
-            arg_0_wired = f_args[2]["toWireType"](None, arg0)
-            rv = invoker(invoke_fcn, arg_0_wired)
-            if is_r:
-                ret = f_args[0]["fromWireType"](rv)
-                return ret
-            return None
-
-        def executor2(
-            arg0: Any,
-            arg1: Any,
-            invoker: Callable = cpp_invoker_func,
-            invoke_fcn: int = cpp_target_func,
-            f_args: list[Any] = arg_types,
-            is_r: bool = returns,
-        ) -> Any:
-            arg_0_wired = f_args[2]["toWireType"](None, arg0)
-            arg_1_wired = f_args[3]["toWireType"](None, arg1)
-            rv = invoker(invoke_fcn, arg_0_wired, arg_1_wired)
-            if is_r:
-                ret = f_args[0]["fromWireType"](rv)
-                return ret
-            return None
-
-        def executor3(
-            arg0: Any,
-            arg1: Any,
-            arg2: Any,
-            invoker: Callable = cpp_invoker_func,
-            invoke_fcn: int = cpp_target_func,
-            f_args: list[Any] = arg_types,
-            is_r: bool = returns,
-        ) -> Any:
-            arg_0_wired = f_args[2]["toWireType"](None, arg0)
-            arg_1_wired = f_args[3]["toWireType"](None, arg1)
-            arg_2_wired = f_args[4]["toWireType"](None, arg2)
-            rv = invoker(invoke_fcn, arg_0_wired, arg_1_wired, arg_2_wired)
-            if is_r:
-                ret = f_args[0]["fromWireType"](rv)
-                return ret
-            return None
-
-        if arg_count - 2 == 0:
-            return lambda: executor0(cpp_invoker_func, cpp_target_func, arg_types)
-        if arg_count - 2 == 1:
-            return lambda *args: executor1(args[0], cpp_invoker_func, cpp_target_func, arg_types)
-        if arg_count - 2 == 2:
-            return lambda *args: executor2(
-                args[0], args[1], cpp_invoker_func, cpp_target_func, arg_types
-            )
-        if arg_count - 2 == 3:
-            return lambda *args: executor3(
-                args[0], args[1], args[2], cpp_invoker_func, cpp_target_func, arg_types
-            )
-        raise RuntimeError(f"arg_count={arg_count} not implemented in executor")
+        factory = invoker_factory(len(arg_types) - 2, returns)
+        return cast(
+            Callable,
+            factory(
+                cpp_invoker_func,
+                cpp_target_func,
+                arg_types[0]["fromWireType"],
+                *[arg_type["toWireType"] for arg_type in arg_types[2:]],
+            ),
+        )
 
     def shared_register_type(
         self, raw_type: int, registered_instance: Any, options: dict[str, Any]
@@ -1725,39 +1351,108 @@ class WebixDapperWasm:
 
         return self.with_stack_save(fcn_caller)
 
+    def set_threw(self, threw: int, value: int) -> None:
+        self.exports["setThrew"](self.store, threw, value)
+
+    def set_temp_ret0(self, value: int) -> None:
+        if self._tempret_set is not None:
+            self._tempret_set(self.store, value)
+
+    def get_exception_ptr(self, exc_info: WasmExceptionInfo) -> int:
+        if self.invoke("__cxa_is_pointer_type", exc_info.get_type()):
+            return int.from_bytes(
+                self.memory.read(self.store, exc_info.exc_ptr, exc_info.exc_ptr + 4), "little"
+            )
+        return exc_info.get_adjusted_ptr() or exc_info.exc_ptr
+
     def __cxa_throw(self, ptr: int, ex_type: int, destructor: int) -> None:
         exc_info = WasmExceptionInfo(ptr, self.memory, self.store)
         exc_info.init(ex_type, destructor)
-        exc_data = self.get_exception_message(ptr)
-        raise RuntimeError(f"{str(exc_data)}")
+        self.exception_last = ptr
+        self.uncaught_exceptions += 1
+        raise WasmCppException(self.get_exception_message(ptr), ptr)
 
-    def __cxa_begin_catch(self, ptr: int) -> None:
-        # pylint: disable=unused-argument
-        raise NotImplementedError("Not implemented __cxa_begin_catch")
+    def __cxa_begin_catch(self, ptr: int) -> int:
+        exc_info = WasmExceptionInfo(ptr, self.memory, self.store)
+        if not exc_info.get_caught():
+            exc_info.set_caught(True)
+            self.uncaught_exceptions -= 1
+        exc_info.set_rethrown(False)
+        self.exceptions_caught.append(exc_info)
+        self.invoke("__cxa_increment_exception_refcount", ptr)
+        return self.get_exception_ptr(exc_info)
 
     def __cxa_end_catch(self) -> None:
-        raise NotImplementedError("Not implemented __cxa_end_catch")
+        self.set_threw(0, 0)
+        exc_info = self.exceptions_caught.pop()
+        self.invoke("__cxa_decrement_exception_refcount", exc_info.exc_ptr)
+        self.exception_last = 0
 
     def __cxa_rethrow(self) -> None:
-        raise NotImplementedError("Not implemented __cxa_rethrow")
+        if not self.exceptions_caught:
+            raise RuntimeError("no exception to throw")
+        exc_info = self.exceptions_caught.pop()
+        if not exc_info.get_rethrown():
+            self.exceptions_caught.append(exc_info)
+            exc_info.set_rethrown(True)
+            exc_info.set_caught(False)
+            self.uncaught_exceptions += 1
+        self.exception_last = exc_info.exc_ptr
+        raise WasmCppException(self.get_exception_message(exc_info.exc_ptr), exc_info.exc_ptr)
 
     def __assert_fail(self, condition: int, filename: int, line: int, func: int) -> None:
         # pylint: disable=unused-argument
         raise NotImplementedError("Not implemented __assert_fail")
 
-    def __cxa_find_matching_catch_2(self) -> None:
-        raise NotImplementedError("Not implemented __cxa_find_matching_catch_2")
-
-    def __cxa_find_matching_catch_3(self, arg0: int) -> None:
-        # pylint: disable=unused-argument
-        raise NotImplementedError("Not implemented __cxa_find_matching_catch_3")
+    def find_matching_catch(self, caught_types: Tuple[int, ...]) -> int:
+        if not (thrown := self.exception_last):
+            self.set_temp_ret0(0)
+            return 0
+        exc_info = WasmExceptionInfo(thrown, self.memory, self.store)
+        exc_info.set_adjusted_ptr(thrown)
+        if not (thrown_type := exc_info.get_type()):
+            self.set_temp_ret0(0)
+            return thrown
+        for caught_type in caught_types:
+            if caught_type in (0, thrown_type):
+                break
+            if self.invoke("__cxa_can_catch", caught_type, thrown_type, exc_info.ptr + 16):
+                self.set_temp_ret0(caught_type)
+                return thrown
+        self.set_temp_ret0(thrown_type)
+        return thrown
 
-    def __cxa_uncaught_exceptions(self) -> None:
-        raise NotImplementedError("Not implemented __cxa_uncaught_exceptions")
+    def __cxa_uncaught_exceptions(self) -> int:
+        return self.uncaught_exceptions
 
     def __resume_exception(self, ptr: int) -> None:
-        # pylint: disable=unused-argument
-        raise NotImplementedError("Not implemented __resumeException")
+        if not self.exception_last:
+            self.exception_last = ptr
+        raise WasmCppException(self.get_exception_message(self.exception_last), self.exception_last)
+
+    def dapper_host_transfer(self, tx: int, tx_size: int, rx: int, rx_size: int) -> int:
+        if self.host_write_data is None or self.host_read_data is None:
+            return -1
+        self.host_write_data(Uint8Array(self.HEAPU8, tx, tx_size))
+        data = self.host_read_data()
+        Uint8Array(self.HEAPU8, rx, rx_size).set(data)
+        return len(data)
+
+    def enable_host_transfer(
+        self, write_data: Callable[[Uint8Array], None], read_data: Callable[[], Uint8Array]
+    ) -> bool:
+        """Exchange probe packets directly over linear memory instead of emval readData/writeData calls.
+
+        :param write_data: Handler sending packet to the probe
+        :param read_data: Handler receiving response from the probe
+        :return: False if the module does not support direct transfer
+        """
+        if (enable := self.direct_export("dapperSetHostTransfer")) is None:
+            return False
+        self.host_write_data = write_data
+        self.host_read_data = read_data
+        enable(1)
+        return True
 
     def _emval_run_destructors(self, handle: int) -> None:
         # pylint: disable=unused-argument
@@ -1788,8 +1483,6 @@ class WebixDapperWasm:
             "__assert_fail": self.__assert_fail,
             "__cxa_begin_catch": self.__cxa_begin_catch,
             "__cxa_end_catch": self.__cxa_end_catch,
-            "__cxa_find_matching_catch_2": self.__cxa_find_matching_catch_2,
-            "__cxa_find_matching_catch_3": self.__cxa_find_matching_catch_3,
             "__cxa_rethrow": self.__cxa_rethrow,
             "__cxa_throw": self.__cxa_throw,
             "__cxa_uncaught_exceptions": self.__cxa_uncaught_exceptions,
@@ -1821,6 +1514,7 @@ class WebixDapperWasm:
             "_emval_run_destructors": self._emval_run_destructors,
             "_emval_take_value": self._emval_take_value,
             "abort": self.abort,
+            "dapperHostTransfer": self.dapper_host_transfer,
             "emscripten_sleep": self.emscripten_sleep,
             "emscripten_memcpy_js": self.emscripten_memcpy_js,
             "emscripten_resize_heap": self.emscripten_resize_heap,
@@ -1829,45 +1523,22 @@ class WebixDapperWasm:
             "fd_close": self.fd_close,
             "fd_seek": self.fd_seek,
             "fd_write": self.fd_write,
-            "invoke_diii": self.invoke_diii,
-            "invoke_fiii": self.invoke_fiii,
-            "invoke_id": self.invoke_id,
-            "invoke_i": self.invoke_i,
-            "invoke_ii": self.invoke_ii,
-            "invoke_iii": self.invoke_iii,
-            "invoke_iiii": self.invoke_iiii,
-            "invoke_iiiii": self.invoke_iiiii,
-            "invoke_iiiiii": self.invoke_iiiiii,
-            "invoke_iiiiiii": self.invoke_iiiiiii,
-            "invoke_iiiiiiii": self.invoke_iiiiiiii,
-            "invoke_iiiiiiiii": self.invoke_iiiiiiiii,
-            "invoke_iiiiiiiiii": self.invoke_iiiiiiiiii,
-            "invoke_iiiiiiiiiii": self.invoke_iiiiiiiiiii,
-            "invoke_iiiiiiiiiiii": self.invoke_iiiiiiiiiiii,
-            "invoke_iiiiiiiiiiiii": self.invoke_iiiiiiiiiiiii,
-            "invoke_jiiii": self.invoke_jiiii,
-            "invoke_v": self.invoke_v,
-            "invoke_vi": self.invoke_vi,
-            "invoke_vid": self.invoke_vid,
-            "invoke_vii": self.invoke_vii,
-            "invoke_viii": self.invoke_viii,
-            "invoke_viiii": self.invoke_viiii,
-            "invoke_viiiii": self.invoke_viiiii,
-            "invoke_viiiiii": self.invoke_viiiiii,
-            "invoke_viiiiiii": self.invoke_viiiiiii,
-            "invoke_viiiiiiii": self.invoke_viiiiiiii,
-            "invoke_viiiiiiiii": self.invoke_viiiiiiiii,
-            "invoke_viiiiiiiiii": self.invoke_viiiiiiiiii,
-            "invoke_viiiiiiiiiii": self.invoke_viiiiiiiiiii,
-            "invoke_viiiiiiiiiiii": self.invoke_viiiiiiiiiiii,
-            "invoke_viiiiiiiiiiiii": self.invoke_viiiiiiiiiiiii,
-            "invoke_viiiiiiiiiiiiii": self.invoke_viiiiiiiiiiiiii,
-            "invoke_viiiiiiiiiiiiiii": self.invoke_viiiiiiiiiiiiiii,
             "strftime_l": self.strftime_l,
         }
         for imp in self.module.imports:
             if (name := imp.name) in wasm_imports:
                 import_array.append(Func(self.store, cast(FuncType, imp.type), wasm_imports[name]))
+            elif name.startswith("invoke_"):
+                trampoline = invoke_factory(name[len("invoke_") :])(self)
+                import_array.append(Func(self.store, cast(FuncType, imp.type), trampoline))
+            elif name.startswith("__cxa_find_matching_catch_"):
+                import_array.append(
+                    Func(
+                        self.store,
+                        cast(FuncType, imp.type),
+                        lambda *caught_types: self.find_matching_catch(caught_types),
+                    )
+                )
             else:
                 raise RuntimeError(f"{str(name)} not found in wasm imports")
         return import_array
@@ -0,0 +1,350 @@
+/* ********************************************************************************************************* *
+ *
+ * Copyright 2025 Oidis
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+ * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+ *
+ * ********************************************************************************************************* */
+
+#ifndef WEBIX_DAPPER_DAPCOMMANDS_HPP_
+#define WEBIX_DAPPER_DAPCOMMANDS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+namespace wix {
+    namespace dap {
+        // full-speed HID report, every CMSIS-DAP probe accepts at least this packet size
+        constexpr std::size_t MIN_PACKET_SIZE = 64;
+
+        enum class Command : uint8_t {
+            Info = 0x00,
+            Connect = 0x02,
+            Disconnect = 0x03,
+            TransferConfigure = 0x04,
+            Transfer = 0x05,
+            TransferBlock = 0x06,
+            SWJPins = 0x10,
+            SWJClock = 0x11,
+            SWJSequence = 0x12,
+            SWDConfigure = 0x13,
+            SWDSequence = 0x1d,
+            ExecuteCommands = 0x7f,
+            Vendor1 = 0x81
+        };
+
+        enum class Port : uint8_t {
+            DP = 0,
+            AP = 1
+        };
+
+        // DP/AP register addresses, only A[3:2] goes to the wire
+        constexpr uint8_t DP_ABORT = 0x00;
+        constexpr uint8_t DP_DPIDR = 0x00;
+        constexpr uint8_t DP_CTRL_STAT = 0x04;
+        constexpr uint8_t DP_SELECT = 0x08;
+        constexpr uint8_t DP_RDBUFF = 0x0c;
+        constexpr uint8_t DP_TARGETSEL = 0x0c;
+        constexpr uint8_t AP_CSW = 0x00;
+        constexpr uint8_t AP_TAR = 0x04;
+        constexpr uint8_t AP_DRW = 0x0c;
+
+        constexpr uint8_t ACK_OK = 0x01;
+        constexpr uint8_t ACK_WAIT = 0x02;
+        constexpr uint8_t ACK_FAULT = 0x04;
+        constexpr uint8_t ACK_NONE = 0x07;  // line not driven by any target
+
+        // DAP_Transfer request byte: APnDP, RnW, A[3:2]
+        constexpr uint8_t requestByte(Port port, bool read, uint8_t address) {
+            return (address & ~0x0c) != 0 ? throw std::runtime_error("Invalid DP/AP register address")
+                                           : static_cast<uint8_t>(static_cast<uint8_t>(port) | (read ? 0x02 : 0x00) | address);
+        }
+
+        template<Port port, uint8_t address>
+        constexpr uint8_t READ = requestByte(port, true, address);
+
+        template<Port port, uint8_t address>
+        constexpr uint8_t WRITE = requestByte(port, false, address);
+
+        // little-endian field, keeps request/response structs byte packed and independent of host byte order
+        template<typename T>
+        struct Le {
+            uint8_t bytes[sizeof(T)];
+
+            constexpr Le()
+                : bytes{} {
+            }
+
+            constexpr Le(T value)  // NOLINT(google-explicit-constructor)
+                : bytes{} {
+                for (std::size_t i = 0; i < sizeof(T); ++i) {
+                    bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+                }
+            }
+
+            constexpr operator T() const {  // NOLINT(google-explicit-constructor)
+                T value = 0;
+                for (std::size_t i = 0; i < sizeof(T); ++i) {
+                    value |= static_cast<T>(static_cast<T>(bytes[i]) << (8 * i));
+                }
+                return value;
+            }
+        };
+
+        using Le16 = Le<uint16_t>;
+        using Le32 = Le<uint32_t>;
+
+        /** Fixed-layout requests **/
+        struct InfoRequest {
+            uint8_t command = static_cast<uint8_t>(Command::Info);
+            uint8_t id;
+
+            constexpr explicit InfoRequest(uint8_t id)
+                : id(id) {
+            }
+        };
+
+        struct ConnectRequest {
+            uint8_t command = static_cast<uint8_t>(Command::Connect);
+            uint8_t port;
+
+            constexpr explicit ConnectRequest(uint8_t port)
+                : port(port) {
+            }
+        };
+
+        struct DisconnectRequest {
+            uint8_t command = static_cast<uint8_t>(Command::Disconnect);
+        };
+
+        struct TransferConfigureRequest {
+            uint8_t command = static_cast<uint8_t>(Command::TransferConfigure);
+            uint8_t idleCycles;
+            Le16 waitRetry;
+            Le16 matchRetry;
+
+            constexpr TransferConfigureRequest(uint8_t idleCycles, uint16_t waitRetry, uint16_t matchRetry)
+                : idleCycles(idleCycles)
+                , waitRetry(waitRetry)
+                , matchRetry(matchRetry) {
+            }
+        };
+
+        struct SWJPinsRequest {
+            uint8_t command = static_cast<uint8_t>(Command::SWJPins);
+            uint8_t output;
+            uint8_t select;
+            Le32 wait;
+
+            constexpr SWJPinsRequest(uint8_t output, uint8_t select, uint32_t wait)
+                : output(output)
+                , select(select)
+                , wait(wait) {
+            }
+        };
+
+        struct SWJClockRequest {
+            uint8_t command = static_cast<uint8_t>(Command::SWJClock);
+            Le32 clock;
+
+            constexpr explicit SWJClockRequest(uint32_t clock)
+                : clock(clock) {
+            }
+        };
+
+        struct SWDConfigureRequest {
+            uint8_t command = static_cast<uint8_t>(Command::SWDConfigure);
+            uint8_t configuration;
+
+            constexpr explicit SWDConfigureRequest(uint8_t configuration)
+                : configuration(configuration) {
+            }
+        };
+
+        struct VendorRequest {
+            uint8_t command = static_cast<uint8_t>(Command::Vendor1);
+            uint8_t argument;
+
+            constexpr explicit VendorRequest(uint8_t argument)
+                : argument(argument) {
+            }
+        };
+
+        struct TransferBlockRequest {
+            uint8_t command = static_cast<uint8_t>(Command::TransferBlock);
+            uint8_t index;
+            Le16 count;
+            uint8_t request;
+
+            constexpr TransferBlockRequest(uint8_t index, uint16_t count, uint8_t request)
+                : index(index)
+                , count(count)
+                , request(request) {
+            }
+        };
+
+        /** Fixed-layout response headers **/
+        struct StatusResponse {
+            Command command;
+            uint8_t status;
+        };
+
+        struct InfoResponse {
+            Command command;
+            uint8_t length;
+        };
+
+        struct TransferResponse {
+            Command command;
+            uint8_t count;
+            uint8_t ack;
+        };
+
+        struct TransferBlockResponse {
+            Command command;
+            Le16 count;
+            uint8_t ack;
+        };
+
+        // writes fixed-layout request at the start of packet, only bytes of the request are touched
+        template<typename T>
+        inline std::size_t put(uint8_t *buffer, const T &request) {
+            static_assert(std::is_trivially_copyable<T>::value && alignof(T) == 1, "request layout must be byte packed");
+            static_assert(sizeof(T) <= MIN_PACKET_SIZE, "request does not fit into the smallest packet");
+            std::memcpy(buffer, &request, sizeof(T));
+            return sizeof(T);
+        }
+
+        template<typename T>
+        inline T get(const uint8_t *buffer, std::size_t size, std::size_t offset = 0) {
+            static_assert(std::is_trivially_copyable<T>::value && alignof(T) == 1, "response layout must be byte packed");
+            if (offset + sizeof(T) > size) {
+                throw std::runtime_error("DAP response exceeds packet size");
+            }
+            T value;
+            std::memcpy(&value, buffer + offset, sizeof(T));
+            return value;
+        }
+
+        // variable-length request, every append is checked against negotiated packet size
+        class Packet {
+         public:
+            Packet(uint8_t *buffer, std::size_t capacity, Command command)
+                : buffer(buffer)
+                , capacity(capacity) {
+                u8(static_cast<uint8_t>(command));
+            }
+
+            Packet &u8(uint8_t value) {
+                reserve(1);
+                buffer[size++] = value;
+                return *this;
+            }
+
+            Packet &u32(uint32_t value) {
+                reserve(sizeof(Le32));
+                size += put(buffer + size, Le32(value));
+                return *this;
+            }
+
+            Packet &bytes(const void *data, std::size_t count) {
+                reserve(count);
+                std::memcpy(buffer + size, data, count);
+                size += count;
+                return *this;
+            }
+
+            Packet &fill(uint8_t value, std::size_t count) {
+                reserve(count);
+                std::memset(buffer + size, value, count);
+                size += count;
+                return *this;
+            }
+
+            std::size_t length() const {
+                return size;
+            }
+
+         protected:
+            uint8_t *buffer;
+            std::size_t capacity;
+            std::size_t size = 0;
+
+            void reserve(std::size_t count) const {
+                if (size + count > capacity) {
+                    throw std::runtime_error("DAP request exceeds packet size");
+                }
+            }
+        };
+
+        // DAP_Transfer with any number of DP/AP accesses, response with all read words must fit into one packet too
+        class Transfer : public Packet {
+         public:
+            Transfer(uint8_t *buffer, std::size_t capacity, uint8_t index = 0)
+                : Packet(buffer, capacity, Command::Transfer) {
+                u8(index).u8(0);
+            }
+
+            template<Port port, uint8_t address>
+            Transfer &read() {
+                return append(READ<port, address>);
+            }
+
+            template<Port port, uint8_t address>
+            Transfer &write(uint32_t value) {
+                append(WRITE<port, address>);
+                u32(value);
+                return *this;
+            }
+
+            Transfer &read(Port port, uint8_t address) {
+                return append(requestByte(port, true, address));
+            }
+
+            Transfer &write(Port port, uint8_t address, uint32_t value) {
+                append(requestByte(port, false, address));
+                u32(value);
+                return *this;
+            }
+
+            // true when given accesses fit into this request and read words into its response
+            bool fits(int requests, int writes, int reads) const {
+                return buffer[2] + requests <= 0xff && size + requests + writes * sizeof(Le32) <= capacity &&
+                       sizeof(TransferResponse) + (readCount + reads) * sizeof(Le32) <= capacity;
+            }
+
+            int count() const {
+                return buffer[2];
+            }
+
+            int reads() const {
+                return readCount;
+            }
+
+         private:
+            int readCount = 0;
+
+            Transfer &append(uint8_t request) {
+                if (buffer[2] == 0xff) {
+                    throw std::runtime_error("DAP transfer count overflow");
+                }
+                if (request & 0x02) {
+                    if (sizeof(TransferResponse) + (readCount + 1) * sizeof(Le32) > capacity) {
+                        throw std::runtime_error("DAP response exceeds packet size");
+                    }
+                    readCount++;
+                }
+                u8(request);
+                buffer[2]++;
+                return *this;
+            }
+        };
+    }  // namespace dap
+}  // namespace wix
+
+#endif  // WEBIX_DAPPER_DAPCOMMANDS_HPP_
@@ -0,0 +1,654 @@
+/* ********************************************************************************************************* *
+ *
+ * Copyright 2025 Oidis
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+ * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+ *
+ * ********************************************************************************************************* */
+
+#include "DapSimulator.hpp"
+#include "DapCommands.hpp"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+
+namespace wix {
+    namespace sim {
+        namespace {
+            const uint32_t DPIDR = 0x2ba01477;  // SW-DP v1, designer ARM
+            const uint32_t DPIDR_V2 = 0x2ba02477;  // SW-DP v2 with multi-drop support
+            const uint32_t AP_IDR = 0x24770011;  // AHB-AP, MEM-AP class
+            const uint32_t PPB_BASE = 0xe0000000;
+            const uint32_t PPB_END = 0xe0100000;
+            const uint32_t ROM_TABLE = 0xe00ff000;
+            const uint32_t CORE_ROM_TABLE = 0xe00fe000;  // CoreSight class 0x9 table as found on Armv8-M cores
+            const uint32_t AIRCR = 0xe000ed0c;
+            const uint32_t DHCSR = 0xe000edf0;
+            const uint32_t DCRSR = 0xe000edf4;
+            const uint32_t DCRDR = 0xe000edf8;
+            const uint32_t DEMCR = 0xe000edfc;
+            const uint32_t DWT_PCSR = 0xe000101c;
+            const uint32_t FP_CTRL = 0xe0002000;
+            const uint32_t DHCSR_KEY = 0xa05f0000;
+            const uint32_t AIRCR_SYSRESETREQ = 0x05fa0004;  // VECTKEY | SYSRESETREQ
+            const uint32_t XPSR_THUMB = 1 << 24;
+            const uint32_t CTRL_STAT_STICKYERR = 1 << 5;
+            const uint32_t CTRL_STAT_REQUESTS = 0x50000000;  // CSYSPWRUPREQ | CDBGPWRUPREQ
+
+            inline uint32_t nextRandom(uint32_t &state) {
+                state = state * 1664525 + 1013904223;
+                return state >> 8;
+            }
+
+            inline uint32_t load32(const uint8_t *data) {
+                return dap::get<dap::Le32>(data, sizeof(dap::Le32));
+            }
+
+            inline void store32(uint8_t *data, uint32_t value) {
+                dap::put(data, dap::Le32(value));
+            }
+
+            inline bool inRegion(uint32_t address, uint32_t base, uint32_t size) {
+                return address >= base && address - base < size;
+            }
+        }  // namespace
+
+        TargetModel::TargetModel(const SimulatorConfig &config)
+            : config(config)
+            , flashData(config.flashSize, 0xff)
+            , ramData(config.ramSize, 0x00)
+            , ports(std::max<uint32_t>(config.instances, 1))
+            , dp(&ports[0])
+            , random(config.seed ^ 0x5a5a5a5a) {
+            // ROM table entries are offsets from table base, bit 0 marks present entry of class 0x1 table,
+            // class 0x9 table has PRESENT in bits [1:0] where 0b10 is a skipped entry and 0b00 ends the table
+            ppb[ROM_TABLE + 0x000] = ((CORE_ROM_TABLE - ROM_TABLE) & 0xfffff000) | 0x3;
+            ppb[CORE_ROM_TABLE + 0x000] = ((0xe000e000 - CORE_ROM_TABLE) & 0xfffff000) | 0x3;
+            ppb[CORE_ROM_TABLE + 0x004] = ((0xe0001000 - CORE_ROM_TABLE) & 0xfffff000) | 0x3;
+            ppb[CORE_ROM_TABLE + 0x008] = ((0xe0000000 - CORE_ROM_TABLE) & 0xfffff000) | 0x2;  // ITM powered down
+            ppb[CORE_ROM_TABLE + 0x00c] = ((0xe0002000 - CORE_ROM_TABLE) & 0xfffff000) | 0x3;
+            addComponent(ROM_TABLE, 0x1, 0x4c4);
+            addComponent(CORE_ROM_TABLE, 0x9, 0x4c9);
+            ppb[CORE_ROM_TABLE + 0xfbc] = 0x47700af7;  // DEVARCH: architect ARM, present, ROM table
+            addComponent(0xe000e000, 0xe, 0x00c);
+            addComponent(0xe0001000, 0xe, 0x002);
+            addComponent(0xe0002000, 0xe, 0x003);
+            ppb[FP_CTRL] = 0x260;  // FPBv1, 6 code and 2 literal comparators, disabled
+            resetCore();
+        }
+
+        void TargetModel::resetCore() {
+            std::fill(std::begin(core), std::end(core), 0);
+            if (flashData.size() >= 8) {  // initial SP and reset vector
+                core[13] = load32(&flashData[0]) & ~0x03u;
+                core[15] = load32(&flashData[4]) & ~0x01u;
+            }
+            core[16] = XPSR_THUMB;
+            auto demcr = ppb.find(DEMCR);
+            if (demcr != ppb.end() && (demcr->second & 0x01) && (dhcsr & 0x01)) {  // VC_CORERESET
+                dhcsr |= 0x02;
+            }
+        }
+
+        void TargetModel::addComponent(uint32_t address, uint8_t cidrClass, uint16_t partNo) {
+            const uint16_t designer = 0x43b;  // ARM, JEP106 continuation 4, identity 0x3b
+            ppb[address + 0xfd0] = designer >> 8;
+            ppb[address + 0xfe0] = partNo & 0xff;
+            ppb[address + 0xfe4] = ((partNo >> 8) & 0x0f) | ((designer & 0x0f) << 4);
+            ppb[address + 0xfe8] = 0x08 | ((designer >> 4) & 0x07);
+            ppb[address + 0xff0] = 0x0d;
+            ppb[address + 0xff4] = static_cast<uint32_t>(cidrClass) << 4;
+            ppb[address + 0xff8] = 0x05;
+            ppb[address + 0xffc] = 0xb1;
+        }
+
+        void TargetModel::lineReset() {
+            afterLineReset = true;
+            if (config.instances == 0) {
+                dp->select = 0;
+            } else {
+                // every instance is selected again, more of them answer at once and the host sees no acknowledge
+                dp = config.instances == 1 ? &ports[0] : nullptr;
+            }
+        }
+
+        void TargetModel::targetSelect(uint32_t targetSel) {
+            if (config.instances == 0 || !afterLineReset) {
+                return;
+            }
+            afterLineReset = false;
+            uint32_t instance = targetSel >> 28;
+            bool match = (targetSel & 0x0fffffff) == (config.targetId & 0x0fffffff) && instance < config.instances;
+            dp = match ? &ports[instance] : nullptr;
+        }
+
+        uint8_t TargetModel::access(bool accessPort, bool read, uint8_t address, uint32_t &data) {
+            if (config.instances > 0 && !accessPort && !read && address == dap::DP_TARGETSEL) {
+                targetSelect(data);
+                return dap::ACK_NONE;
+            }
+            afterLineReset = false;
+            if (dp == nullptr) {
+                return dap::ACK_NONE;
+            }
+            return accessPort ? accessAP(read, address, data) : accessDP(read, address, data);
+        }
+
+        uint8_t TargetModel::accessDP(bool read, uint8_t address, uint32_t &data) {
+            switch (address) {
+                case dap::DP_DPIDR:
+                    if (read) {
+                        data = config.instances == 0 ? DPIDR : DPIDR_V2;
+                    } else if (data & 0x1e) {  // ABORT: STKCMPCLR | STKERRCLR | WDERRCLR | ORUNERRCLR
+                        dp->stickyError = false;
+                    }
+                    break;
+                case dap::DP_CTRL_STAT:
+                    if (config.instances > 0 && (dp->select & 0x0f) >= 2) {
+                        // read-only TARGETID and DLPIDR banks of DPv2
+                        if (read) {
+                            data = (dp->select & 0x0f) == 2 ? config.targetId : (static_cast<uint32_t>(dp - ports.data()) << 28) | 0x01;
+                        }
+                    } else if (read) {
+                        // power-up acknowledges follow requests immediately
+                        data = dp->ctrlStat | ((dp->ctrlStat & CTRL_STAT_REQUESTS) << 1) | (dp->stickyError ? CTRL_STAT_STICKYERR : 0);
+                    } else {
+                        dp->ctrlStat = data & 0x5f000f00;
+                    }
+                    break;
+                case dap::DP_SELECT:
+                    if (read) {
+                        data = dp->readBuffer;  // RESEND
+                    } else {
+                        dp->select = data;
+                    }
+                    break;
+                default:
+                    if (read) {
+                        data = dp->readBuffer;  // RDBUFF
+                    }  // TARGETSEL write is ignored by single drop target
+                    break;
+            }
+            return dap::ACK_OK;
+        }
+
+        uint8_t TargetModel::accessAP(bool read, uint8_t address, uint32_t &data) {
+            if (dp->stickyError) {
+                return dap::ACK_FAULT;
+            }
+            uint8_t ack = dap::ACK_OK;
+            uint32_t value = 0;
+            uint32_t reg = (dp->select & 0xf0) | address;
+            if ((dp->select >> 24) != 0) {
+                // APSEL without access port reads as zero
+            } else if (reg == dap::AP_CSW) {
+                if (read) {
+                    value = csw;
+                } else {
+                    csw = (data & 0x7f000037) | 0x40;
+                }
+            } else if (reg == dap::AP_TAR) {
+                if (read) {
+                    value = tar;
+                } else {
+                    tar = data;
+                }
+            } else if (reg == dap::AP_DRW) {
+                value = data;
+                ack = accessMemory(read, tar, value);
+                if (ack == dap::ACK_OK && (csw & 0x30)) {
+                    // auto increment wraps at 1kB boundary as on real MEM-AP
+                    tar = (tar & ~0x3ffu) | ((tar + (1u << (csw & 0x07))) & 0x3ff);
+                }
+            } else if (reg >= 0x10 && reg <= 0x1c) {  // BD0-BD3
+                value = data;
+                ack = accessMemory(read, (tar & ~0x0fu) | (reg & 0x0c), value);
+            } else if (reg == 0xf8) {
+                value = ROM_TABLE | 0x3;
+            } else if (reg == 0xfc) {
+                value = AP_IDR;
+            }
+            if (read && ack == dap::ACK_OK) {
+                data = value;
+                dp->readBuffer = value;
+            }
+            return ack;
+        }
+
+        uint8_t TargetModel::accessMemory(bool read, uint32_t address, uint32_t &data) {
+            uint32_t size = csw & 0x07;
+            uint32_t bytes = 1u << size;
+            uint32_t word;
+            bool ok = size <= 2 && (address & (bytes - 1)) == 0 && busRead(address & ~0x03u, word);
+            if (ok && read) {
+                data = word;  // byte and halfword data stay on their byte lanes
+            } else if (ok) {
+                uint32_t mask = (bytes == 4 ? 0xffffffff : ((1u << (8 * bytes)) - 1)) << (8 * (address & 0x03));
+                ok = busWrite(address & ~0x03u, (word & ~mask) | (data & mask));
+            }
+            if (!ok) {
+                dp->stickyError = true;
+                return dap::ACK_FAULT;
+            }
+            return dap::ACK_OK;
+        }
+
+        bool TargetModel::busRead(uint32_t address, uint32_t &data) {
+            if (inRegion(address, config.flashBase, config.flashSize - 3)) {
+                data = load32(&flashData[address - config.flashBase]);
+            } else if (inRegion(address, config.ramBase, config.ramSize - 3)) {
+                data = load32(&ramData[address - config.ramBase]);
+            } else if (address == DHCSR) {
+                // S_REGRDY, S_HALT when halted by debugger
+                data = (dhcsr & 0x0f) | (1 << 16) | ((dhcsr & 0x03) == 0x03 ? (1 << 17) : 0);
+            } else if (address == DCRDR) {
+                data = dcrdr;
+            } else if (address == DWT_PCSR) {
+                data = samplePC();
+            } else if (address >= PPB_BASE && address < PPB_END) {
+                auto it = ppb.find(address);
+                data = it == ppb.end() ? 0 : it->second;
+            } else {
+                return false;
+            }
+            return true;
+        }
+
+        bool TargetModel::busWrite(uint32_t address, uint32_t data) {
+            if (inRegion(address, config.ramBase, config.ramSize - 3)) {
+                store32(&ramData[address - config.ramBase], data);
+            } else if (address == DHCSR) {
+                if ((data & 0xffff0000) == DHCSR_KEY) {
+                    writeDhcsr(data & 0x0f);
+                }
+            } else if (address == DCRSR) {
+                // register transfer completes immediately, S_REGRDY stays set
+                uint32_t selector = data & 0x7f;
+                if (selector < sizeof(core) / sizeof(core[0])) {
+                    if (data & (1 << 16)) {
+                        core[selector] = dcrdr;
+                    } else {
+                        dcrdr = core[selector];
+                    }
+                }
+            } else if (address == DCRDR) {
+                dcrdr = data;
+            } else if (address == AIRCR) {
+                if (data == AIRCR_SYSRESETREQ) {
+                    resetCore();
+                }
+            } else if (address == FP_CTRL) {
+                if (data & 0x02) {  // KEY
+                    ppb[FP_CTRL] = (ppb[FP_CTRL] & ~0x01u) | (data & 0x01);
+                }
+            } else if (address >= PPB_BASE && address < PPB_END) {
+                if (address < CORE_ROM_TABLE && (address & 0xfff) < 0xfd0) {
+                    ppb[address] = data;
+                }  // ROM table and ID registers are read-only
+            } else {
+                return false;  // flash is programmed by its controller only, direct write ends with bus error
+            }
+            return true;
+        }
+
+        // halted core steps one halfword instruction, running core stops at random PC
+        void TargetModel::writeDhcsr(uint32_t value) {
+            bool halted = (dhcsr & 0x03) == 0x03;
+            // C_MASKINTS changed together with C_HALT clear is UNPREDICTABLE, model keeps the previous value
+            if (halted && !(value & 0x02) && ((value ^ dhcsr) & 0x08)) {
+                value = (value & ~0x08u) | (dhcsr & 0x08);
+            }
+            if (halted && (value & 0x07) == 0x05) {  // C_DEBUGEN | C_STEP without C_HALT
+                core[15] += 2;
+                value |= 0x02;
+            } else if (!halted && (value & 0x03) == 0x03) {
+                core[15] = randomCodeAddress();
+            }
+            dhcsr = value;
+        }
+
+        // running core is modelled as random walk over first kB of flash
+        uint32_t TargetModel::samplePC() {
+            auto demcr = ppb.find(DEMCR);
+            if ((dhcsr & 0x03) == 0x03 || demcr == ppb.end() || !(demcr->second & (1 << 24))) {
+                return 0xffffffff;
+            }
+            return randomCodeAddress();
+        }
+
+        uint32_t TargetModel::randomCodeAddress() {
+            return config.flashBase + ((nextRandom(random) % std::min<uint32_t>(config.flashSize, 0x400)) & ~0x01u);
+        }
+
+        DapSimulator::DapSimulator(const SimulatorConfig &config)
+            : config(config)
+            , model(config)
+            , random(config.seed) {
+            if (config.packetSize < dap::MIN_PACKET_SIZE || config.packetSize > 0xffff) {
+                throw std::runtime_error("Invalid simulator packet size");
+            }
+            if (config.flashSize < 4 || config.ramSize < 4 || (config.flashSize | config.ramSize) & 0x03) {
+                throw std::runtime_error("Invalid simulator memory size");
+            }
+        }
+
+        void DapSimulator::checkRequest(const uint8_t *position, std::size_t size) const {
+            if (position + size > requestEnd) {
+                throw std::runtime_error("DAP request exceeds packet size");
+            }
+        }
+
+        void DapSimulator::checkResponse(const uint8_t *position, std::size_t size) const {
+            if (position + size > responseEnd) {
+                throw std::runtime_error("DAP response exceeds packet size");
+            }
+        }
+
+        std::size_t DapSimulator::transfer(const uint8_t *request, std::size_t requestSize, uint8_t *response, std::size_t responseSize) {
+            statistics.packets++;
+            requestEnd = request + std::min<std::size_t>(requestSize, config.packetSize);
+            responseEnd = response + std::min<std::size_t>(responseSize, config.packetSize);
+            uint8_t *position = response;
+            command(request, position);
+            return position - response;
+        }
+
+        const uint8_t *DapSimulator::command(const uint8_t *request, uint8_t *&response) {
+            checkRequest(request, 1);
+            auto id = static_cast<dap::Command>(request[0]);
+            if (id == dap::Command::Info) {
+                return info(request, response);
+            } else if (id == dap::Command::Transfer) {
+                return transferCommand(request, response);
+            } else if (id == dap::Command::TransferBlock) {
+                return transferBlockCommand(request, response);
+            } else if (id == dap::Command::SWDSequence) {
+                return swdSequenceCommand(request, response);
+            } else if (id == dap::Command::ExecuteCommands) {
+                checkRequest(request, 2);
+                checkResponse(response, 2);
+                uint8_t count = request[1];
+                *response++ = request[0];
+                *response++ = count;
+                const uint8_t *next = request + 2;
+                for (uint8_t i = 0; i < count; i++) {
+                    next = command(next, response);
+                }
+                return next;
+            }
+
+            // commands with status response only
+            std::size_t size;
+            uint8_t status = 0;
+            switch (id) {
+                case dap::Command::Connect:
+                    checkRequest(request, 2);
+                    status = request[1] <= 1 ? 1 : 0;  // default and SWD port, JTAG is not modelled
+                    size = 2;
+                    break;
+                case dap::Command::Disconnect:
+                    size = 1;
+                    break;
+                case dap::Command::TransferConfigure:
+                    checkRequest(request, 6);
+                    waitRetry = dap::get<dap::Le16>(request, 6, 2);
+                    matchRetry = dap::get<dap::Le16>(request, 6, 4);
+                    size = 6;
+                    break;
+                case dap::Command::SWJPins:
+                    checkRequest(request, 7);
+                    pins = (pins & ~request[2]) | (request[1] & request[2]);
+                    status = pins;
+                    size = 7;
+                    break;
+                case dap::Command::SWJClock:
+                    size = 5;
+                    break;
+                case dap::Command::SWJSequence: {
+                    checkRequest(request, 2);
+                    std::size_t bits = request[1] == 0 ? 256 : request[1];
+                    size = 2 + (bits + 7) / 8;
+                    if (bits >= 50) {
+                        model.lineReset();
+                    }
+                    break;
+                }
+                case dap::Command::SWDConfigure:
+                    size = 2;
+                    break;
+                case dap::Command::Vendor1:
+                    size = 2;
+                    break;
+                default:
+                    checkResponse(response, 1);
+                    *response++ = static_cast<uint8_t>(0xff);  // DAP_Invalid
+                    return requestEnd;
+            }
+            checkRequest(request, size);
+            checkResponse(response, 3);
+            *response++ = request[0];
+            *response++ = status;
+            if (id == dap::Command::Vendor1) {
+                *response++ = 1;  // probe accepted reset request
+            }
+            return request + size;
+        }
+
+        const uint8_t *DapSimulator::info(const uint8_t *request, uint8_t *&response) {
+            checkRequest(request, 2);
+            std::string text;
+            std::vector<uint8_t> value;
+            switch (request[1]) {
+                case 0x01:
+                    text = "Oidis";
+                    break;
+                case 0x02:
+                    text = "Dapper Simulated CMSIS-DAP";
+                    break;
+                case 0x03:
+                    text = "DAPPER-SIM";
+                    break;
+                case 0x04:
+                    text = "2.1.1";
+                    break;
+                case 0x09:
+                    text = "1.0";
+                    break;
+                case 0xf0:
+                    value = {0x01};  // SWD
+                    break;
+                case 0xfd:
+                    value = {0, 0, 0, 0};  // no SWO buffer
+                    break;
+                case 0xfe:
+                    value = {1};
+                    break;
+                case 0xff:
+                    value = {static_cast<uint8_t>(config.packetSize), static_cast<uint8_t>(config.packetSize >> 8)};
+                    break;
+            }
+            if (!text.empty()) {
+                value.assign(text.begin(), text.end());
+                value.push_back(0);
+            }
+            checkResponse(response, 2 + value.size());
+            *response++ = request[0];
+            *response++ = static_cast<uint8_t>(value.size());
+            std::memcpy(response, value.data(), value.size());
+            response += value.size();
+            return request + 2;
+        }
+
+        // one DP/AP access as done by probe: injected WAITs are retried up to host configured count
+        uint8_t DapSimulator::access(uint8_t request, uint32_t &data) {
+            bool accessPort = request & 0x01;
+            statistics.accesses++;
+            for (uint32_t retry = 0; accessPort && nextRandom(random) % 100 < config.waitPercent; retry++) {
+                statistics.waits++;
+                if (retry >= waitRetry) {
+                    return dap::ACK_WAIT;
+                }
+            }
+            uint8_t ack = model.access(accessPort, request & 0x02, request & 0x0c, data);
+            if (ack != dap::ACK_OK) {
+                statistics.faults++;
+            }
+            return ack;
+        }
+
+        const uint8_t *DapSimulator::transferCommand(const uint8_t *request, uint8_t *&response) {
+            checkRequest(request, 3);
+            checkResponse(response, 3);
+            uint8_t *header = response;
+            response += 3;
+            const uint8_t *next = request + 3;
+            uint8_t count = request[2];
+            uint8_t done = 0;
+            uint8_t ack = dap::ACK_OK;
+            for (; done < count; done++) {
+                checkRequest(next, 1);
+                uint8_t transfer = *next++;
+                uint32_t data = 0;
+                bool read = transfer & 0x02;
+                if (!read || (transfer & 0x10)) {
+                    checkRequest(next, 4);
+                    data = load32(next);
+                    next += 4;
+                }
+                if (!read && (transfer & 0x20)) {
+                    matchMask = data;
+                    continue;
+                }
+                if (read && (transfer & 0x10)) {
+                    // value match, read is repeated until masked value matches
+                    uint32_t value = 0;
+                    uint32_t retry = 0;
+                    while ((ack = access(transfer, value)) == dap::ACK_OK && (value & matchMask) != data && retry++ < matchRetry) {
+                    }
+                    if (ack == dap::ACK_OK && (value & matchMask) != data) {
+                        ack |= 0x10;  // value mismatch
+                    }
+                } else {
+                    ack = access(transfer, data);
+                }
+                if (ack != dap::ACK_OK) {
+                    break;
+                }
+                if (read && !(transfer & 0x10)) {
+                    checkResponse(response, 4);
+                    store32(response, data);
+                    response += 4;
+                }
+            }
+            header[0] = request[0];
+            header[1] = done;
+            header[2] = ack;
+            // rest of failed request is not processed by probe
+            return done == count ? next : requestEnd;
+        }
+
+        const uint8_t *DapSimulator::transferBlockCommand(const uint8_t *request, uint8_t *&response) {
+            checkRequest(request, 5);
+            checkResponse(response, 4);
+            uint8_t *header = response;
+            response += 4;
+            uint16_t count = dap::get<dap::Le16>(request, 5, 2);
+            uint8_t transfer = request[4];
+            bool read = transfer & 0x02;
+            const uint8_t *next = request + 5;
+            uint16_t done = 0;
+            uint8_t ack = dap::ACK_OK;
+            for (; done < count; done++) {
+                uint32_t data = 0;
+                if (!read) {
+                    checkRequest(next, 4);
+                    data = load32(next);
+                    next += 4;
+                }
+                if ((ack = access(transfer, data)) != dap::ACK_OK) {
+                    break;
+                }
+                if (read) {
+                    checkResponse(response, 4);
+                    store32(response, data);
+                    response += 4;
+                }
+            }
+            header[0] = request[0];
+            dap::put(header + 1, dap::Le16(done));
+            header[3] = ack;
+            return done == count ? next : requestEnd;
+        }
+
+        const uint8_t *DapSimulator::swdSequenceCommand(const uint8_t *request, uint8_t *&response) {
+            checkRequest(request, 2);
+            checkResponse(response, 2);
+            *response++ = request[0];
+            *response++ = 0;
+            const uint8_t *next = request + 2;
+            std::vector<bool> bits;
+            for (uint8_t i = 0; i < request[1]; i++) {
+                checkRequest(next, 1);
+                uint8_t info = *next++;
+                std::size_t count = (info & 0x3f) == 0 ? 64 : (info & 0x3f);
+                std::size_t bytes = (count + 7) / 8;
+                if (info & 0x80) {
+                    // line is not driven by target model, input reads as ones
+                    checkResponse(response, bytes);
+                    std::memset(response, 0xff, bytes);
+                    response += bytes;
+                } else {
+                    checkRequest(next, bytes);
+                    for (std::size_t bit = 0; bit < count; bit++) {
+                        bits.push_back((next[bit / 8] >> (bit % 8)) & 0x01);
+                    }
+                    next += bytes;
+                }
+            }
+            wire(bits);
+            return next;
+        }
+
+        // host driven bits of SWD sequence (input phases left out): line resets and TARGETSEL writes behind them
+        void DapSimulator::wire(const std::vector<bool> &bits) {
+            const std::size_t targetSelBits = 8 + 33;  // request, data and parity, turnaround and ACK are input phases
+            std::size_t ones = 0;
+            bool reset = false;
+            for (std::size_t i = 0; i < bits.size(); i++) {
+                if (!bits[i]) {
+                    if (ones >= 50) {
+                        model.lineReset();
+                        reset = true;
+                    }
+                    ones = 0;
+                    continue;
+                }
+                if (reset && ones == 0 && i + targetSelBits <= bits.size()) {
+                    uint8_t header = 0;
+                    uint32_t data = 0;
+                    for (std::size_t bit = 0; bit < 8; bit++) {
+                        header |= bits[i + bit] << bit;
+                    }
+                    for (std::size_t bit = 0; bit < 32; bit++) {
+                        data |= static_cast<uint32_t>(bits[i + 8 + bit]) << bit;
+                    }
+                    if (header == 0x99) {  // start, DP, write, A[3:2] = 0b11, parity, stop, park
+                        model.targetSelect(data);
+                        reset = false;
+                        i += targetSelBits - 1;
+                        continue;
+                    }
+                }
+                reset = false;
+                ones++;
+            }
+            if (ones >= 50) {
+                model.lineReset();
+            }
+        }
+    }  // namespace sim
+}  // namespace wix
@@ -0,0 +1,142 @@
+/* ********************************************************************************************************* *
+ *
+ * Copyright 2025 Oidis
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+ * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+ *
+ * ********************************************************************************************************* */
+
+#ifndef WEBIX_DAPPER_DAPSIMULATOR_HPP_
+#define WEBIX_DAPPER_DAPSIMULATOR_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace wix {
+    namespace sim {
+        struct SimulatorConfig {
+            uint32_t packetSize;
+            uint32_t waitPercent;  // chance of WAIT acknowledge for every AP access attempt
+            uint32_t seed;
+            uint32_t flashBase;
+            uint32_t flashSize;
+            uint32_t ramBase;
+            uint32_t ramSize;
+            uint32_t targetId;  // TARGETID of multi-drop SW-DP v2 instances
+            uint32_t instances;  // number of multi-drop instances (TINSTANCE 0..n-1), 0 for single drop SW-DP v1
+        };
+
+        struct SimulatorStats {
+            uint32_t packets;
+            uint32_t accesses;
+            uint32_t waits;
+            uint32_t faults;
+        };
+
+        // ADIv5 SW-DP with single AHB-AP (APSEL 0) in front of Cortex-M like memory map:
+        // read-only flash, RAM and private peripheral bus with class 0x1 ROM table pointing to class 0x9 core ROM table
+        // with SCS, DWT and FPB,
+        // core registers are reachable over DCRSR/DCRDR, halt, step and reset follow DHCSR, DEMCR and AIRCR.
+        // Multi-drop instances have their own DP state and share the rest, only target picked by TARGETSEL responds.
+        class TargetModel {
+         public:
+            explicit TargetModel(const SimulatorConfig &config);
+
+            // one DP/AP access without WAIT injection, returns SWD acknowledge
+            uint8_t access(bool accessPort, bool read, uint8_t address, uint32_t &data);
+
+            void lineReset();
+
+            // TARGETSEL write is taken only right after line reset and it is never acknowledged
+            void targetSelect(uint32_t targetSel);
+
+            std::vector<uint8_t> &flash() {
+                return flashData;
+            }
+
+            std::vector<uint8_t> &ram() {
+                return ramData;
+            }
+
+         private:
+            SimulatorConfig config;
+            std::vector<uint8_t> flashData;
+            std::vector<uint8_t> ramData;
+            std::unordered_map<uint32_t, uint32_t> ppb;
+
+            struct DebugPort {
+                uint32_t ctrlStat = 0;
+                uint32_t select = 0;
+                uint32_t readBuffer = 0;
+                bool stickyError = false;
+            };
+
+            std::vector<DebugPort> ports;
+            DebugPort *dp;  // nullptr when no target drives the line
+            bool afterLineReset = false;
+            uint32_t csw = 0x03000040;  // DeviceEn, word size, no increment
+            uint32_t tar = 0;
+            uint32_t dhcsr = 0;
+            uint32_t dcrdr = 0;
+            uint32_t core[21];  // r0-r15, xPSR, MSP, PSP, reserved, CONTROL/FAULTMASK/BASEPRI/PRIMASK
+            uint32_t random;
+
+            uint8_t accessDP(bool read, uint8_t address, uint32_t &data);
+            uint8_t accessAP(bool read, uint8_t address, uint32_t &data);
+            uint8_t accessMemory(bool read, uint32_t address, uint32_t &data);
+            bool busRead(uint32_t address, uint32_t &data);
+            bool busWrite(uint32_t address, uint32_t data);
+            uint32_t samplePC();
+            uint32_t randomCodeAddress();
+            void writeDhcsr(uint32_t value);
+            void resetCore();
+            void addComponent(uint32_t address, uint8_t cidrClass, uint16_t partNo);
+        };
+
+        // CMSIS-DAP v2 command processor over TargetModel, probe retries injected WAITs as configured by host
+        class DapSimulator {
+         public:
+            explicit DapSimulator(const SimulatorConfig &config);
+
+            // processes one request packet, returns response size
+            std::size_t transfer(const uint8_t *request, std::size_t requestSize, uint8_t *response, std::size_t responseSize);
+
+            const SimulatorStats &stats() const {
+                return statistics;
+            }
+
+            TargetModel &target() {
+                return model;
+            }
+
+         private:
+            SimulatorConfig config;
+            TargetModel model;
+            SimulatorStats statistics{};
+            uint16_t waitRetry = 100;
+            uint16_t matchRetry = 0;
+            uint32_t matchMask = 0xffffffff;
+            uint8_t pins = 0xff;
+            uint32_t random;
+            const uint8_t *requestEnd = nullptr;
+            const uint8_t *responseEnd = nullptr;
+
+            // every command handler returns pointer behind its request and advances response pointer
+            const uint8_t *command(const uint8_t *request, uint8_t *&response);
+            const uint8_t *info(const uint8_t *request, uint8_t *&response);
+            const uint8_t *transferCommand(const uint8_t *request, uint8_t *&response);
+            const uint8_t *transferBlockCommand(const uint8_t *request, uint8_t *&response);
+            const uint8_t *swdSequenceCommand(const uint8_t *request, uint8_t *&response);
+            uint8_t access(uint8_t request, uint32_t &data);
+            void wire(const std::vector<bool> &bits);
+            void checkRequest(const uint8_t *position, std::size_t size) const;
+            void checkResponse(const uint8_t *position, std::size_t size) const;
+        };
+    }  // namespace sim
+}  // namespace wix
+
+#endif  // WEBIX_DAPPER_DAPSIMULATOR_HPP_
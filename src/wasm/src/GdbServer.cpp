@@ -0,0 +1,423 @@
+/* ********************************************************************************************************* *
+ *
+ * Copyright 2025 Oidis
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+ * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+ *
+ * ********************************************************************************************************* */
+
+#include "GdbServer.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <stdexcept>
+
+namespace wix {
+    namespace gdb {
+        namespace {
+            const std::size_t MAX_PACKET_SIZE = 0x4000;
+            const int STEP_POLL_COUNT = 100;
+            const int SIGNAL_INT = 2;
+            const int SIGNAL_TRAP = 5;
+
+            const char TARGET_XML[] =
+                    "<?xml version=\"1.0\"?>"
+                    "<!DOCTYPE target SYSTEM \"gdb-target.dtd\">"
+                    "<target version=\"1.0\">"
+                    "<architecture>arm</architecture>"
+                    "<feature name=\"org.gnu.gdb.arm.m-profile\">"
+                    "<reg name=\"r0\" bitsize=\"32\"/><reg name=\"r1\" bitsize=\"32\"/>"
+                    "<reg name=\"r2\" bitsize=\"32\"/><reg name=\"r3\" bitsize=\"32\"/>"
+                    "<reg name=\"r4\" bitsize=\"32\"/><reg name=\"r5\" bitsize=\"32\"/>"
+                    "<reg name=\"r6\" bitsize=\"32\"/><reg name=\"r7\" bitsize=\"32\"/>"
+                    "<reg name=\"r8\" bitsize=\"32\"/><reg name=\"r9\" bitsize=\"32\"/>"
+                    "<reg name=\"r10\" bitsize=\"32\"/><reg name=\"r11\" bitsize=\"32\"/>"
+                    "<reg name=\"r12\" bitsize=\"32\"/>"
+                    "<reg name=\"sp\" bitsize=\"32\" type=\"data_ptr\"/>"
+                    "<reg name=\"lr\" bitsize=\"32\"/>"
+                    "<reg name=\"pc\" bitsize=\"32\" type=\"code_ptr\"/>"
+                    "<reg name=\"xpsr\" bitsize=\"32\"/>"
+                    "</feature>"
+                    "</target>";
+
+            inline bool startsWith(const std::string &value, const char *prefix) {
+                return value.compare(0, std::char_traits<char>::length(prefix), prefix) == 0;
+            }
+
+            inline int hexDigit(char c) {
+                if (c >= '0' && c <= '9') {
+                    return c - '0';
+                } else if (c >= 'a' && c <= 'f') {
+                    return c - 'a' + 10;
+                } else if (c >= 'A' && c <= 'F') {
+                    return c - 'A' + 10;
+                }
+                throw std::runtime_error("Invalid hex digit in GDB packet");
+            }
+
+            // parses hex number from position, position is moved behind it
+            uint32_t parseHex(const std::string &value, std::size_t &position) {
+                std::size_t start = position;
+                uint32_t result = 0;
+                while (position < value.size() && std::isxdigit(static_cast<unsigned char>(value[position]))) {
+                    result = (result << 4) | hexDigit(value[position++]);
+                }
+                if (position == start) {
+                    throw std::runtime_error("Missing number in GDB packet");
+                }
+                return result;
+            }
+
+            inline void expect(const std::string &value, std::size_t &position, char separator) {
+                if (position >= value.size() || value[position] != separator) {
+                    throw std::runtime_error("Malformed GDB packet");
+                }
+                position++;
+            }
+
+            std::string toHex(const uint8_t *data, std::size_t size) {
+                static const char digits[] = "0123456789abcdef";
+                std::string result(2 * size, '0');
+                for (std::size_t i = 0; i < size; i++) {
+                    result[2 * i] = digits[data[i] >> 4];
+                    result[2 * i + 1] = digits[data[i] & 0x0f];
+                }
+                return result;
+            }
+
+            std::vector<uint8_t> fromHex(const std::string &value, std::size_t position, std::size_t size) {
+                if (position + 2 * size > value.size()) {
+                    throw std::runtime_error("Truncated GDB packet");
+                }
+                std::vector<uint8_t> result(size);
+                for (std::size_t i = 0; i < size; i++) {
+                    result[i] = static_cast<uint8_t>(hexDigit(value[position + 2 * i]) << 4 | hexDigit(value[position + 2 * i + 1]));
+                }
+                return result;
+            }
+
+            // registers go little endian, as target stores them
+            std::string registerHex(uint32_t value) {
+                uint8_t bytes[4] = {static_cast<uint8_t>(value), static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value >> 16),
+                                    static_cast<uint8_t>(value >> 24)};
+                return toHex(bytes, sizeof(bytes));
+            }
+
+            uint32_t parseRegister(const std::string &value, std::size_t position) {
+                auto bytes = fromHex(value, position, 4);
+                return bytes[0] | bytes[1] << 8 | bytes[2] << 16 | static_cast<uint32_t>(bytes[3]) << 24;
+            }
+
+            // qXfer read of document part, "l" marks the last one
+            std::string transferPart(const std::string &document, const std::string &request, std::size_t position) {
+                uint32_t offset = parseHex(request, position);
+                expect(request, position, ',');
+                uint32_t length = std::min<uint32_t>(parseHex(request, position), MAX_PACKET_SIZE / 2);
+                if (offset >= document.size()) {
+                    return "l";
+                }
+                return (offset + length >= document.size() ? "l" : "m") + document.substr(offset, length);
+            }
+
+            std::string memoryMapXml(const std::vector<MemoryRegion> &regions) {
+                std::string xml = "<?xml version=\"1.0\"?><!DOCTYPE memory-map SYSTEM \"gdb-memory-map.dtd\"><memory-map>";
+                char line[160];
+                for (const auto &region: regions) {
+                    if (region.type == MemoryType::Flash) {
+                        std::snprintf(line, sizeof(line),
+                                      "<memory type=\"flash\" start=\"0x%x\" length=\"0x%x\"><property name=\"blocksize\">0x%x</property></memory>",
+                                      region.base, region.size, region.blockSize);
+                    } else {
+                        std::snprintf(line, sizeof(line), "<memory type=\"%s\" start=\"0x%x\" length=\"0x%x\"/>",
+                                      region.type == MemoryType::Rom ? "rom" : "ram", region.base, region.size);
+                    }
+                    xml += line;
+                }
+                return xml + "</memory-map>";
+            }
+        }  // namespace
+
+        Server::Server(Target &target)
+            : target(target) {
+        }
+
+        std::string Server::packet(const std::string &payload) {
+            std::string result = "$";
+            uint8_t checksum = 0;
+            for (char c: payload) {
+                if (c == '#' || c == '$' || c == '}' || c == '*') {
+                    result += '}';
+                    checksum += '}';
+                    c ^= 0x20;
+                }
+                result += c;
+                checksum += static_cast<uint8_t>(c);
+            }
+            char trailer[4];
+            std::snprintf(trailer, sizeof(trailer), "#%02x", checksum);
+            return result + trailer;
+        }
+
+        std::string Server::receive(const std::string &data) {
+            input += data;
+            std::string output;
+            std::size_t position = 0;
+            while (position < input.size()) {
+                char c = input[position];
+                if (c == '\x03') {
+                    position++;
+                    if (isRunning) {
+                        target.halt();
+                        isRunning = false;
+                        output += packet(stop(SIGNAL_INT));
+                    }
+                    continue;
+                } else if (c == '-' && !noAck) {
+                    position++;
+                    output += lastReply;
+                    continue;
+                } else if (c != '$') {
+                    position++;  // acknowledges and line noise
+                    continue;
+                }
+                auto hash = input.find('#', position);
+                if (hash == std::string::npos || hash + 2 >= input.size()) {
+                    break;  // rest of packet comes with next chunk
+                }
+                std::string request = input.substr(position + 1, hash - position - 1);
+                std::string checksum = input.substr(hash + 1, 2);
+                position = hash + 3;
+                if (!noAck) {
+                    uint8_t sum = 0;
+                    for (char b: request) {
+                        sum += static_cast<uint8_t>(b);
+                    }
+                    std::size_t offset = 0;
+                    if (!std::isxdigit(static_cast<unsigned char>(checksum[0])) || !std::isxdigit(static_cast<unsigned char>(checksum[1])) ||
+                        parseHex(checksum, offset) != sum) {
+                        output += '-';
+                        continue;
+                    }
+                    output += '+';
+                }
+                bool respond = true;
+                std::string reply;
+                try {
+                    reply = handle(request, respond);
+                } catch (const std::exception &) {
+                    reply = "E01";
+                }
+                if (respond) {
+                    lastReply = packet(reply);
+                    output += lastReply;
+                }
+                if (request == "QStartNoAckMode") {
+                    noAck = true;
+                }
+            }
+            input.erase(0, position);
+            return output;
+        }
+
+        std::string Server::poll() {
+            if (isRunning && target.halted()) {
+                isRunning = false;
+                return packet(stop(SIGNAL_TRAP));
+            }
+            return "";
+        }
+
+        std::string Server::stop(int signal) {
+            char reply[4];
+            std::snprintf(reply, sizeof(reply), "S%02x", signal);
+            return reply;
+        }
+
+        std::string Server::handle(const std::string &request, bool &respond) {
+            if (request.empty()) {
+                return "";
+            }
+            std::size_t position = 1;
+            switch (request[0]) {
+                case '?':
+                    return stop(SIGNAL_TRAP);
+                case 'g':
+                    return readRegisters();
+                case 'G':
+                    return writeRegisters(request);
+                case 'p':
+                    return readRegister(request);
+                case 'P':
+                    return writeRegister(request);
+                case 'm':
+                    return readMemory(request);
+                case 'M':
+                    return writeMemory(request);
+                case 'Z':
+                case 'z':
+                    return breakpoint(request);
+                case 'q':
+                case 'Q':
+                    return handleQuery(request);
+                case 'H':
+                case 'T':
+                    return "OK";
+                case 'c':
+                case 's':
+                    if (position < request.size()) {
+                        uint32_t pc = parseHex(request, position);
+                        uint32_t values[REGISTER_COUNT] = {};
+                        values[15] = pc;
+                        target.writeRegisters(values, 1 << 15);
+                    }
+                    if (request[0] == 'c') {
+                        target.resume(false);
+                        isRunning = true;
+                        respond = false;
+                        return "";
+                    }
+                    target.resume(true);
+                    for (int i = 0; i < STEP_POLL_COUNT; i++) {
+                        if (target.halted()) {
+                            return stop(SIGNAL_TRAP);
+                        }
+                    }
+                    // step did not complete yet (core waits in WFI, stalled bus), reported by poll() as continue is
+                    isRunning = true;
+                    respond = false;
+                    return "";
+                case 'D':
+                    target.resume(false);
+                    isDetached = true;
+                    return "OK";
+                case 'k':
+                    isDetached = true;
+                    respond = false;
+                    return "";
+                default:
+                    return "";  // not supported
+            }
+        }
+
+        std::string Server::handleQuery(const std::string &request) {
+            if (startsWith(request, "qSupported")) {
+                char features[128];
+                std::snprintf(features, sizeof(features), "PacketSize=%zx;qXfer:features:read+;QStartNoAckMode+;hwbreak+%s", MAX_PACKET_SIZE,
+                              target.memoryMap().empty() ? "" : ";qXfer:memory-map:read+");
+                return features;
+            } else if (request == "QStartNoAckMode") {
+                return "OK";
+            } else if (request == "qAttached") {
+                return "1";
+            } else if (request == "qC") {
+                return "QC1";
+            } else if (request == "qfThreadInfo") {
+                return "m1";
+            } else if (request == "qsThreadInfo") {
+                return "l";
+            } else if (startsWith(request, "qSymbol")) {
+                return "OK";
+            } else if (startsWith(request, "qXfer:features:read:target.xml:")) {
+                return transferPart(TARGET_XML, request, sizeof("qXfer:features:read:target.xml:") - 1);
+            } else if (startsWith(request, "qXfer:memory-map:read::")) {
+                return transferPart(memoryMapXml(target.memoryMap()), request, sizeof("qXfer:memory-map:read::") - 1);
+            } else if (startsWith(request, "qRcmd,")) {
+                return monitor(request);
+            }
+            return "";
+        }
+
+        // all registers are read in one probe round trip, single register read does the same
+        std::string Server::readRegisters() {
+            uint32_t values[REGISTER_COUNT];
+            target.readRegisters(values);
+            std::string reply;
+            for (uint32_t value: values) {
+                reply += registerHex(value);
+            }
+            return reply;
+        }
+
+        std::string Server::writeRegisters(const std::string &request) {
+            uint32_t values[REGISTER_COUNT];
+            for (int i = 0; i < REGISTER_COUNT; i++) {
+                values[i] = parseRegister(request, 1 + 8 * i);
+            }
+            target.writeRegisters(values, (1u << REGISTER_COUNT) - 1);
+            return "OK";
+        }
+
+        std::string Server::readRegister(const std::string &request) {
+            std::size_t position = 1;
+            uint32_t index = parseHex(request, position);
+            if (index >= REGISTER_COUNT) {
+                return "xxxxxxxx";
+            }
+            uint32_t values[REGISTER_COUNT];
+            target.readRegisters(values);
+            return registerHex(values[index]);
+        }
+
+        std::string Server::writeRegister(const std::string &request) {
+            std::size_t position = 1;
+            uint32_t index = parseHex(request, position);
+            expect(request, position, '=');
+            if (index >= REGISTER_COUNT) {
+                return "E01";
+            }
+            uint32_t values[REGISTER_COUNT] = {};
+            values[index] = parseRegister(request, position);
+            target.writeRegisters(values, 1u << index);
+            return "OK";
+        }
+
+        std::string Server::readMemory(const std::string &request) {
+            std::size_t position = 1;
+            uint32_t address = parseHex(request, position);
+            expect(request, position, ',');
+            uint32_t size = std::min<uint32_t>(parseHex(request, position), MAX_PACKET_SIZE / 2);
+            std::vector<uint8_t> data(size);
+            target.readMemory(address, data.data(), size);
+            return toHex(data.data(), size);
+        }
+
+        std::string Server::writeMemory(const std::string &request) {
+            std::size_t position = 1;
+            uint32_t address = parseHex(request, position);
+            expect(request, position, ',');
+            uint32_t size = parseHex(request, position);
+            expect(request, position, ':');
+            auto data = fromHex(request, position, size);
+            target.writeMemory(address, data.data(), size);
+            return "OK";
+        }
+
+        // Z0 software breakpoints are placed to FPB as well, flash can not be patched by debugger
+        std::string Server::breakpoint(const std::string &request) {
+            std::size_t position = 1;
+            uint32_t type = parseHex(request, position);
+            expect(request, position, ',');
+            uint32_t address = parseHex(request, position);
+            if (type > 1) {
+                return "";  // watchpoints are not supported
+            }
+            return target.breakpoint(address, request[0] == 'Z') ? "OK" : "E0e";
+        }
+
+        std::string Server::monitor(const std::string &request) {
+            auto bytes = fromHex(request, 6, (request.size() - 6) / 2);
+            std::string command(bytes.begin(), bytes.end());
+            if (command == "reset" || command == "reset halt") {
+                target.reset();
+                return "OK";
+            } else if (command == "halt") {
+                target.halt();
+                return "OK";
+            }
+            const char help[] = "Supported monitor commands: reset, halt\n";
+            return toHex(reinterpret_cast<const uint8_t *>(help), sizeof(help) - 1);
+        }
+    }  // namespace gdb
+}  // namespace wix
@@ -0,0 +1,101 @@
+/* ********************************************************************************************************* *
+ *
+ * Copyright 2025 Oidis
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+ * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+ *
+ * ********************************************************************************************************* */
+
+#ifndef WEBIX_DAPPER_GDBSERVER_HPP_
+#define WEBIX_DAPPER_GDBSERVER_HPP_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace wix {
+    namespace gdb {
+        // r0-r12, sp, lr, pc and xpsr in order of target description and 'g' packet
+        const int REGISTER_COUNT = 17;
+
+        enum class MemoryType {
+            Ram,
+            Flash,
+            Rom,
+        };
+
+        struct MemoryRegion {
+            MemoryType type;
+            uint32_t base;
+            uint32_t size;
+            uint32_t blockSize;  // erase block of flash
+        };
+
+        // debugged core, every method is expected to end in as few probe round trips as possible
+        class Target {
+         public:
+            virtual ~Target() = default;
+
+            virtual void readMemory(uint32_t address, uint8_t *data, uint32_t size) = 0;
+            virtual void writeMemory(uint32_t address, const uint8_t *data, uint32_t size) = 0;
+            virtual void readRegisters(uint32_t *values) = 0;
+            // writes registers selected by mask bits
+            virtual void writeRegisters(const uint32_t *values, uint32_t mask) = 0;
+            virtual void halt() = 0;
+            virtual void resume(bool step) = 0;
+            virtual bool halted() = 0;
+            virtual void reset() = 0;
+            // returns false when no hardware comparator is free or address is out of its range
+            virtual bool breakpoint(uint32_t address, bool insert) = 0;
+            virtual std::vector<MemoryRegion> memoryMap() = 0;
+        };
+
+        // GDB remote serial protocol over any byte stream, all complete packets of received chunk are answered at once
+        class Server {
+         public:
+            explicit Server(Target &target);
+
+            // processes bytes received from client and returns bytes to be sent back
+            std::string receive(const std::string &data);
+
+            // stop reply once running target halts, empty while it keeps running
+            std::string poll();
+
+            bool running() const {
+                return isRunning;
+            }
+
+            bool detached() const {
+                return isDetached;
+            }
+
+            // frames payload, '#', '$', '}' and '*' are escaped
+            static std::string packet(const std::string &payload);
+
+         private:
+            Target &target;
+            std::string input;
+            bool noAck = false;
+            bool isRunning = false;
+            bool isDetached = false;
+            std::string lastReply;  // sent again when client asks for retransmission
+
+            // respond is cleared for requests answered later (continue) or never (kill)
+            std::string handle(const std::string &request, bool &respond);
+            std::string handleQuery(const std::string &request);
+            std::string readMemory(const std::string &request);
+            std::string writeMemory(const std::string &request);
+            std::string readRegisters();
+            std::string writeRegisters(const std::string &request);
+            std::string readRegister(const std::string &request);
+            std::string writeRegister(const std::string &request);
+            std::string breakpoint(const std::string &request);
+            std::string monitor(const std::string &request);
+            std::string stop(int signal);
+        };
+    }  // namespace gdb
+}  // namespace wix
+
+#endif  // WEBIX_DAPPER_GDBSERVER_HPP_
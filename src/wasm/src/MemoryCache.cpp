@@ -0,0 +1,98 @@
+/* ********************************************************************************************************* *
+ *
+ * Copyright 2025 Oidis
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+ * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+ *
+ * ********************************************************************************************************* */
+
+#include "MemoryCache.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace wix {
+    namespace mem {
+        void PageCache::setEnabled(bool enabled) {
+            isEnabled = enabled;
+            if (!enabled) {
+                clear();
+            }
+        }
+
+        void PageCache::read(uint32_t address, uint8_t *data, uint32_t size, const PolicyOf &policy, const HaltProbe &halted,
+                             const Reader &reader) {
+            uint64_t end = static_cast<uint64_t>(address) + size;
+            uint64_t position = address;
+            uint64_t directStart = 0;
+            bool direct = false;
+            auto flush = [&](uint64_t to) {
+                if (direct) {
+                    reader(static_cast<uint32_t>(directStart), data + (directStart - address), static_cast<uint32_t>(to - directStart));
+                    counters.bypassed++;
+                    direct = false;
+                }
+            };
+            while (position < end) {
+                auto page = static_cast<uint32_t>(position & ~static_cast<uint64_t>(PAGE_SIZE - 1));
+                uint64_t chunkEnd = std::min(end, static_cast<uint64_t>(page) + PAGE_SIZE);
+                CachePolicy pagePolicy = isEnabled ? policy(page) : CachePolicy::Never;
+                if (pagePolicy == CachePolicy::Halted && core == CoreState::Unknown) {
+                    setHalted(halted());
+                }
+                if (pagePolicy == CachePolicy::Always || (pagePolicy == CachePolicy::Halted && core == CoreState::Halted)) {
+                    flush(position);
+                    auto cached = pages.find(page);
+                    if (cached == pages.end()) {
+                        Page entry{pagePolicy, std::vector<uint8_t>(PAGE_SIZE)};
+                        reader(page, entry.data.data(), PAGE_SIZE);
+                        if (pages.size() >= MAX_PAGES) {
+                            clear();
+                        }
+                        cached = pages.emplace(page, std::move(entry)).first;
+                        counters.misses++;
+                    } else {
+                        counters.hits++;
+                    }
+                    std::memcpy(data + (position - address), cached->second.data.data() + (position - page), chunkEnd - position);
+                } else if (!direct) {
+                    direct = true;
+                    directStart = position;
+                }
+                position = chunkEnd;
+            }
+            flush(end);
+        }
+
+        void PageCache::invalidate(uint32_t address, uint32_t size) {
+            if (size == 0 || pages.empty()) {
+                return;
+            }
+            uint64_t last = (static_cast<uint64_t>(address) + size - 1) & ~static_cast<uint64_t>(PAGE_SIZE - 1);
+            for (uint64_t page = address & ~(PAGE_SIZE - 1); page <= last; page += PAGE_SIZE) {
+                counters.invalidations += static_cast<uint32_t>(pages.erase(static_cast<uint32_t>(page)));
+            }
+        }
+
+        void PageCache::setHalted(bool halted) {
+            if (core == CoreState::Halted && !halted) {
+                for (auto page = pages.begin(); page != pages.end();) {
+                    if (page->second.policy == CachePolicy::Halted) {
+                        page = pages.erase(page);
+                        counters.invalidations++;
+                    } else {
+                        ++page;
+                    }
+                }
+            }
+            core = halted ? CoreState::Halted : CoreState::Running;
+        }
+
+        void PageCache::clear() {
+            counters.invalidations += static_cast<uint32_t>(pages.size());
+            pages.clear();
+            core = CoreState::Unknown;
+        }
+    }  // namespace mem
+}  // namespace wix
@@ -0,0 +1,95 @@
+/* ********************************************************************************************************* *
+ *
+ * Copyright 2025 Oidis
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+ * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+ *
+ * ********************************************************************************************************* */
+
+#ifndef WEBIX_DAPPER_MEMORYCACHE_HPP_
+#define WEBIX_DAPPER_MEMORYCACHE_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace wix {
+    namespace mem {
+        enum class CachePolicy {
+            Never,   // peripherals and unknown memory
+            Halted,  // RAM, valid only while core stays halted
+            Always,  // ROM and flash, valid until write or reset
+        };
+
+        struct CacheStats {
+            uint32_t hits;           // pages served from host memory
+            uint32_t misses;         // pages filled from target
+            uint32_t bypassed;       // target reads of uncacheable ranges
+            uint32_t invalidations;  // dropped pages
+        };
+
+        // Target memory cache with pages of MEM-AP auto increment block, so every miss costs one block read
+        class PageCache {
+         public:
+            static constexpr uint32_t PAGE_SIZE = 0x400;
+
+            using Reader = std::function<void(uint32_t address, uint8_t *data, uint32_t size)>;
+            using PolicyOf = std::function<CachePolicy(uint32_t page)>;
+            using HaltProbe = std::function<bool()>;
+
+            // disabled cache passes every read to reader and keeps no pages
+            void setEnabled(bool enabled);
+
+            bool enabled() const {
+                return isEnabled;
+            }
+
+            // reads through cache, consecutive uncacheable pages go to reader as one range,
+            // halt state is probed only when it is not known (after clear), running core is not probed again
+            // until debugger reports it halted, so RAM is never served stale but polling costs no extra packets
+            void read(uint32_t address, uint8_t *data, uint32_t size, const PolicyOf &policy, const HaltProbe &halted,
+                      const Reader &reader);
+
+            // drops pages overlapping written range
+            void invalidate(uint32_t address, uint32_t size);
+
+            // halt state seen by debugger, pages valid only while halted are dropped once core runs
+            void setHalted(bool halted);
+
+            // drops all pages and forgets core state (reset, raw access, target change)
+            void clear();
+
+            CacheStats stats() const {
+                return counters;
+            }
+
+            void resetStats() {
+                counters = {};
+            }
+
+         private:
+            static constexpr std::size_t MAX_PAGES = 4096;  // 4 MB of host memory
+
+            enum class CoreState {
+                Unknown,
+                Running,
+                Halted,
+            };
+
+            struct Page {
+                CachePolicy policy;
+                std::vector<uint8_t> data;
+            };
+
+            bool isEnabled = false;
+            CoreState core = CoreState::Unknown;
+            std::unordered_map<uint32_t, Page> pages;
+            CacheStats counters{};
+        };
+    }  // namespace mem
+}  // namespace wix
+
+#endif  // WEBIX_DAPPER_MEMORYCACHE_HPP_
@@ -0,0 +1,147 @@
+/* ********************************************************************************************************* *
+ *
+ * Copyright 2025 Oidis
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+ * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+ *
+ * ********************************************************************************************************* */
+
+#include "MemoryPlanner.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace wix {
+    namespace mem {
+        MemoryPlan::MemoryPlan(const std::vector<MemoryOperation> &operations, const SideEffectFree &sideEffectFree) {
+            std::vector<MemoryOperation> group;
+            bool groupFree = false;
+            for (const auto &operation: operations) {
+                if (operation.size == 0) {
+                    continue;
+                }
+                if (static_cast<uint64_t>(operation.address) + operation.size > 0x100000000ull) {
+                    throw std::runtime_error("Memory operation exceeds address space");
+                }
+                bool free = sideEffectFree(operation.address, operation.size);
+                if (!group.empty() && (group.front().write != operation.write || groupFree != free)) {
+                    planGroup(group, groupFree, sideEffectFree);
+                    group.clear();
+                }
+                groupFree = free;
+                group.push_back(operation);
+            }
+            if (!group.empty()) {
+                planGroup(group, groupFree, sideEffectFree);
+            }
+        }
+
+        void MemoryPlan::scatter() const {
+            for (const auto &copy: copies) {
+                std::memcpy(copy.destination, copy.source, copy.size);
+            }
+        }
+
+        void MemoryPlan::planGroup(const std::vector<MemoryOperation> &group, bool free, const SideEffectFree &sideEffectFree) {
+            bool write = group.front().write;
+            if (!free) {
+                // peripherals get every access exactly once and in list order, only ascending neighbours share TAR
+                uint32_t total = 0;
+                for (const auto &operation: group) {
+                    total += operation.size;
+                }
+                buffers.emplace_back(total);
+                uint8_t *data = buffers.back().data();
+                for (const auto &operation: group) {
+                    if (write) {
+                        std::memcpy(data, operation.data, operation.size);
+                    } else {
+                        copies.push_back({data, operation.data, operation.size});
+                    }
+                    split(write, operation.address, data, operation.size, false);
+                    data += operation.size;
+                }
+                return;
+            }
+
+            struct Range {
+                uint64_t start;
+                uint64_t end;
+                bool widened;
+                uint8_t *data;
+            };
+
+            std::vector<Range> ranges;
+            ranges.reserve(group.size());
+            for (const auto &operation: group) {
+                ranges.push_back({operation.address, static_cast<uint64_t>(operation.address) + operation.size, false, nullptr});
+            }
+            std::sort(ranges.begin(), ranges.end(), [](const Range &a, const Range &b) { return a.start < b.start; });
+
+            std::vector<Range> merged;
+            for (const auto &range: ranges) {
+                if (!merged.empty()) {
+                    auto &last = merged.back();
+                    // written bytes must not be touched outside of operations, reads may cover short gaps
+                    if (range.start <= last.end ||
+                        (!write && range.start - last.end <= MAX_READ_GAP &&
+                         sideEffectFree(static_cast<uint32_t>(last.start), static_cast<uint32_t>(range.end - last.start)))) {
+                        last.end = std::max(last.end, range.end);
+                        continue;
+                    }
+                }
+                merged.push_back(range);
+            }
+
+            for (auto &range: merged) {
+                uint64_t start = range.start & ~0x03ull;
+                uint64_t end = (range.end + 3) & ~0x03ull;
+                if (!write && (start != range.start || end != range.end) &&
+                    sideEffectFree(static_cast<uint32_t>(start), static_cast<uint32_t>(end - start))) {
+                    range.start = start;
+                    range.end = end;
+                }
+                range.widened = !write && (range.start & 0x03) == 0 && (range.end & 0x03) == 0;
+                buffers.emplace_back(range.end - range.start);
+                range.data = buffers.back().data();
+            }
+
+            for (const auto &operation: group) {
+                auto range = std::upper_bound(merged.begin(), merged.end(), operation.address,
+                                              [](uint32_t address, const Range &other) { return address < other.start; }) -
+                             1;
+                uint8_t *data = range->data + (operation.address - range->start);
+                if (write) {
+                    std::memcpy(data, operation.data, operation.size);  // list order, so later write wins
+                } else {
+                    copies.push_back({data, operation.data, operation.size});
+                }
+            }
+
+            for (const auto &range: merged) {
+                split(write, static_cast<uint32_t>(range.start), range.data, static_cast<uint32_t>(range.end - range.start), range.widened);
+            }
+        }
+
+        void MemoryPlan::split(bool write, uint32_t address, uint8_t *data, uint32_t size, bool widened) {
+            while (size) {
+                uint32_t width = widened || ((address & 0x03) == 0 && size >= 4) ? 4 : ((address & 0x01) == 0 && size >= 2) ? 2 : 1;
+                uint32_t blockLeft = AUTO_INCREMENT_BLOCK - (address & (AUTO_INCREMENT_BLOCK - 1));
+                uint32_t count = width == 4 ? std::min(size, blockLeft) / 4 : 1;
+                auto *last = planned.empty() ? nullptr : &planned.back();
+                if (last && last->write == write && last->width == width && last->address + last->count * width == address &&
+                    last->data + last->count * width == data &&
+                    (last->address & ~(AUTO_INCREMENT_BLOCK - 1)) == (address & ~(AUTO_INCREMENT_BLOCK - 1))) {
+                    last->count += count;
+                } else {
+                    planned.push_back({write, address, count, width, data});
+                }
+                address += count * width;
+                data += count * width;
+                size -= count * width;
+            }
+        }
+    }  // namespace mem
+}  // namespace wix
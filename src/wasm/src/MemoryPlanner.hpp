@@ -0,0 +1,76 @@
+/* ********************************************************************************************************* *
+ *
+ * Copyright 2025 Oidis
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+ * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+ *
+ * ********************************************************************************************************* */
+
+#ifndef WEBIX_DAPPER_MEMORYPLANNER_HPP_
+#define WEBIX_DAPPER_MEMORYPLANNER_HPP_
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace wix {
+    namespace mem {
+        // data is source of write or destination of read, size bytes at any alignment
+        struct MemoryOperation {
+            bool write;
+            uint32_t address;
+            uint32_t size;
+            uint8_t *data;
+        };
+
+        // MEM-AP accesses of one size with auto increment TAR, never crossing 1kB auto increment block,
+        // data holds count * width bytes in address order
+        struct MemoryRun {
+            bool write;
+            uint32_t address;
+            uint32_t count;
+            uint32_t width;
+            uint8_t *data;
+        };
+
+        // Scatter-gather plan: consecutive operations of the same direction on side effect free memory form a group
+        // which is sorted and its overlapping or adjacent ranges merged (later write wins), reads are widened to words
+        // and close ranges joined over small gaps. Operations on other memory (peripherals) are never reordered nor
+        // merged, each gets exact accesses with the largest naturally aligned size. Order is kept between groups.
+        class MemoryPlan {
+         public:
+            using SideEffectFree = std::function<bool(uint32_t address, uint32_t size)>;
+
+            MemoryPlan(const std::vector<MemoryOperation> &operations, const SideEffectFree &sideEffectFree);
+
+            const std::vector<MemoryRun> &runs() const {
+                return planned;
+            }
+
+            // copies data of executed read runs to read operations
+            void scatter() const;
+
+         private:
+            static constexpr uint32_t MAX_READ_GAP = 8;  // bytes read over instead of new TAR setup
+            static constexpr uint32_t AUTO_INCREMENT_BLOCK = 0x400;
+
+            struct Copy {
+                const uint8_t *source;
+                uint8_t *destination;
+                uint32_t size;
+            };
+
+            std::deque<std::vector<uint8_t>> buffers;  // merged ranges, deque keeps their data in place
+            std::vector<MemoryRun> planned;
+            std::vector<Copy> copies;
+
+            void planGroup(const std::vector<MemoryOperation> &group, bool free, const SideEffectFree &sideEffectFree);
+            void split(bool write, uint32_t address, uint8_t *data, uint32_t size, bool widened);
+        };
+    }  // namespace mem
+}  // namespace wix
+
+#endif  // WEBIX_DAPPER_MEMORYPLANNER_HPP_
@@ -13,30 +13,33 @@
 #include <emscripten.h>
 #include <emscripten/bind.h>
 
-#define UINT32_EXTRACT(p, i) (p[0 + i] + (p[1 + i] << 8) + (p[2 + i] << 16) + (p[3 + i] << 24))
-#define UINT16_EXTRACT(p, i) (p[0 + i] + (p[1 + i] << 8))
-#define UINT8_EXTRACT(p, i) (p[0 + i])
+#else
 
-#define UINT32_INSERT(v, p, i)                                                                                                             \
-    {                                                                                                                                      \
-        p[0 + i] = (v) & 0xff;                                                                                                             \
-        p[1 + i] = (v >> 8) & 0xff;                                                                                                        \
-        p[2 + i] = (v >> 16) & 0xff;                                                                                                       \
-        p[3 + i] = (v >> 24) & 0xff;                                                                                                       \
-    }
-#define UINT16_INSERT(v, p, i)                                                                                                             \
-    {                                                                                                                                      \
-        p[0 + i] = (v) & 0xff;                                                                                                             \
-        p[1 + i] = (v >> 8) & 0xff;                                                                                                        \
-    }
-#define UINT8_INSERT(v, p, i)                                                                                                              \
-    {                                                                                                                                      \
-        p[0 + i] = (v) & 0xff;                                                                                                             \
-    }
+#include <arpa/inet.h>
+#include <csignal>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 #endif
+#include "DapCommands.hpp"
+#include "DapSimulator.hpp"
+#include "GdbServer.hpp"
 #include "Logger.hpp"
+#include "MemoryCache.hpp"
+#include "MemoryPlanner.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 #ifndef NATIVE_BUILD
 
@@ -48,11 +51,25 @@ void stderrHandler(const std::string &data) {
     emscripten::val::global("stderr")(emscripten::val(data));
 }
 
+#else
+
+void stdoutHandler(const std::string &data) {
+    std::cout << data << std::flush;
+}
+
+void stderrHandler(const std::string &data) {
+    std::cerr << data << std::flush;
+}
+
+#endif
+
 namespace wix {
     static Logger cout(stdoutHandler);
     static Logger cerr(stderrHandler);
 }  // namespace wix
 
+#ifndef NATIVE_BUILD
+
 emscripten::val getSupportedVendorIDs() {
     // read it from embedded probetable.csv or find different way
     // experimental: mculink/dap hardcoded for now: ARM-vid, NXP-vid
@@ -60,16 +77,39 @@ emscripten::val getSupportedVendorIDs() {
     return emscripten::val(emscripten::typed_memory_view(2, probeIDs));
 }
 
-// read from probetable.csv
-const int packetSize = 64;
+#endif
+
+namespace dap = wix::dap;
+
+// negotiated with probe and host transport (see SetPacketSize), every request and response must fit into it
+unsigned int packetSize = dap::MIN_PACKET_SIZE;
 uint32_t last_ap = 0xffffffff;
 
+// multi-drop SWD (DPv2) targets, each keeps its own SELECT cache while deselected
+struct SWDTarget {
+    uint32_t targetSel;
+    uint32_t dpidr;
+    uint32_t lastAp;
+};
+
+std::vector<SWDTarget> swdTargets;
+int activeTarget = -1;
+uint32_t connectedDpidr = 0;
+
 unsigned int rxBufferSize = packetSize;
 uint8_t *rxBuffer = new uint8_t[rxBufferSize];
 
 unsigned int txBufferSize = packetSize;
 uint8_t *txBuffer = new uint8_t[txBufferSize];
 
+// in-process probe and target model replaces host transport while started, see SimulatorStart
+std::unique_ptr<wix::sim::DapSimulator> simulator;
+
+// target memory pages kept on host, see MemoryRead
+wix::mem::PageCache memoryCache;
+
+#ifndef NATIVE_BUILD
+
 inline void readProbeData() {
     auto input = emscripten::val::global("readData")().await();
     auto size = input["length"].as<unsigned int>();
@@ -87,11 +127,41 @@ inline void writeProbeData() {
     emscripten::val::global("writeData")(emscripten::val(emscripten::typed_memory_view(txBufferSize, txBuffer))).await();
 }
 
+// synchronous hosts (Python runtime) exchange packets over linear memory directly, JS keeps emval path
+EM_JS(int, dapperHostTransfer, (uint8_t *tx, int txSize, uint8_t *rx, int rxSize), {
+    return -1;
+});
+
+bool hostTransfer = false;
+
 inline void writeReadProbeData() {
+    if (simulator) {
+        simulator->transfer(txBuffer, txBufferSize, rxBuffer, rxBufferSize);
+        return;
+    }
+    if (hostTransfer) {
+        int size = dapperHostTransfer(txBuffer, txBufferSize, rxBuffer, rxBufferSize);
+        if (size < 0 || size > rxBufferSize) {
+            throw std::runtime_error("HIF transfer error");
+        }
+        return;
+    }
     writeProbeData();
     readProbeData();
 };
 
+#else
+
+// native build has no USB stack, only simulated probe is reachable
+inline void writeReadProbeData() {
+    if (!simulator) {
+        throw std::runtime_error("No probe transport in native build, start simulator");
+    }
+    simulator->transfer(txBuffer, txBufferSize, rxBuffer, rxBufferSize);
+}
+
+#endif
+
 struct DAPCapabilities {
     bool swd;
     bool jtag;
@@ -122,92 +192,147 @@ struct DAPInfo {
     DAPFirmwareInfo firmwareInfo{};
 };
 
-std::string readInfoParam(int code) {
-    txBuffer[0] = 0x00;
-    txBuffer[1] = code;
-    writeReadProbeData();
-    if (rxBuffer[0] != 0x00) {
+// DAP_ExecuteCommands is supported since CMSIS-DAP 2.1, detected from protocol version reported by probe
+bool executeCommands = false;
+
+inline bool protocolAtLeast(const std::string &version, int major, int minor) {
+    int probeMajor = 0;
+    int probeMinor = 0;
+    if (std::sscanf(version.c_str(), "%d.%d", &probeMajor, &probeMinor) < 1) {
+        return false;
+    }
+    return probeMajor > major || (probeMajor == major && probeMinor >= minor);
+}
+
+inline std::string readInfoPayload(std::size_t &offset) {
+    auto response = dap::get<dap::InfoResponse>(rxBuffer, rxBufferSize, offset);
+    if (response.command != dap::Command::Info) {
         throw std::runtime_error("HWIF transfer error");
     }
-    if (rxBuffer[1] == 0) {
+    offset += sizeof(response);
+    if (offset + response.length > rxBufferSize) {
+        throw std::runtime_error("DAP response exceeds packet size");
+    }
+    std::string payload(reinterpret_cast<char *>(rxBuffer + offset), response.length);
+    offset += response.length;
+    return payload;
+}
+
+// raw DAP_Info payloads, queries are batched over DAP_ExecuteCommands when probe and negotiated packet size allow it
+std::vector<std::string> readInfo(const std::vector<uint8_t> &ids) {
+    std::vector<std::string> payloads;
+    payloads.reserve(ids.size());
+    while (payloads.size() < ids.size()) {
+        // single info response is expected to fit into the smallest packet, batch is limited by this bound
+        std::size_t batch = std::min<std::size_t>(ids.size() - payloads.size(), (packetSize - 2) / dap::MIN_PACKET_SIZE);
+        if (!executeCommands || batch < 2) {
+            dap::put(txBuffer, dap::InfoRequest(ids[payloads.size()]));
+            writeReadProbeData();
+            std::size_t offset = 0;
+            payloads.push_back(readInfoPayload(offset));
+            continue;
+        }
+        dap::Packet request(txBuffer, txBufferSize, dap::Command::ExecuteCommands);
+        request.u8(static_cast<uint8_t>(batch));
+        for (std::size_t i = payloads.size(); i < payloads.size() + batch; i++) {
+            request.u8(static_cast<uint8_t>(dap::Command::Info)).u8(ids[i]);
+        }
+        writeReadProbeData();
+        auto response = dap::get<dap::StatusResponse>(rxBuffer, rxBufferSize);
+        if (response.command != dap::Command::ExecuteCommands || response.status != batch) {
+            // probe does not handle it as announced, continue with single requests
+            executeCommands = false;
+            continue;
+        }
+        std::size_t offset = sizeof(response);
+        for (std::size_t i = 0; i < batch; i++) {
+            payloads.push_back(readInfoPayload(offset));
+        }
+    }
+    return payloads;
+}
+
+inline std::string infoString(const std::string &payload) {
+    if (payload.empty()) {
         return {"N/A"};
-    } else if (rxBuffer[1] == 1) {
-        return "";
     }
-    return {reinterpret_cast<char *>(rxBuffer + 2), static_cast<std::size_t>(rxBuffer[1] - 1)};
+    return payload.substr(0, payload.size() - 1);
 }
 
-int readInfoValue(int code) {
-    txBuffer[0] = 0x00;
-    txBuffer[1] = code;
-    writeReadProbeData();
-    int value = 0;
-    switch (rxBuffer[1]) {
-        case 0:
-            break;
-        case 1: {
-            value = static_cast<int>(rxBuffer[2]);
-            break;
-        }
-        case 2:
-            value = UINT16_EXTRACT(rxBuffer, 2);
-            break;
+inline int infoValue(const std::string &payload) {
+    uint32_t value = 0;
+    for (std::size_t i = std::min<std::size_t>(payload.size(), sizeof(uint32_t)); i > 0; i--) {
+        value = (value << 8) | static_cast<uint8_t>(payload[i - 1]);
     }
-    return value;
+    return static_cast<int>(value);
+}
+
+std::string readInfoParam(int code) {
+    return infoString(readInfo({static_cast<uint8_t>(code)})[0]);
+}
+
+int readInfoValue(int code) {
+    return infoValue(readInfo({static_cast<uint8_t>(code)})[0]);
 }
 
 DAPFirmwareInfo getFirmwareInfo() {
     DAPFirmwareInfo firmwareInfo{};
     firmwareInfo.firmwareVersion = readInfoParam(0x04);
-    firmwareInfo.productId = readInfoParam(0x02);
-    firmwareInfo.maxPacketCount = readInfoValue(0xfe);
-    firmwareInfo.maxPacketSize = readInfoValue(0xff);
+    executeCommands = protocolAtLeast(firmwareInfo.firmwareVersion, 2, 1);
+    auto payloads = readInfo({0x02, 0xfe, 0xff});
+    firmwareInfo.productId = infoString(payloads[0]);
+    firmwareInfo.maxPacketCount = infoValue(payloads[1]);
+    firmwareInfo.maxPacketSize = infoValue(payloads[2]);
     return firmwareInfo;
 }
 
-DAPCapabilities getProbeDAPCap() {
+DAPCapabilities infoCapabilities(const std::string &capabilitiesPayload, const std::string &swoBufferPayload) {
     DAPCapabilities capabilities{};
-    txBuffer[0] = 0x00;
-    txBuffer[1] = 0xf0;
-    writeReadProbeData();
-    //  uint8_t bytes = UINT8_EXTRACT(rxBuffer, 1);
-    uint8_t info0 = UINT8_EXTRACT(rxBuffer, 2);
+    int info0 = infoValue(capabilitiesPayload);
     capabilities.swd = (info0 & 0x01) != 0;
     capabilities.jtag = (info0 & 0x02) != 0;
     capabilities.manchester = (info0 & 0x08) != 0;
     capabilities.atomic = (info0 & 0x10) != 0;
     capabilities.swoStreaming = (info0 & 0x40) != 0;
-    capabilities.swoTraceBufferSize = readInfoValue(0xFD);
+    capabilities.swoTraceBufferSize = infoValue(swoBufferPayload);
     return capabilities;
 }
 
 DAPInfo getProbeDAPInfo() {
     DAPInfo info{};
-    getFirmwareInfo();
-    info.targetName = readInfoParam(0x06);
-    info.targetVendor = readInfoParam(0x05);
-    info.boardName = readInfoParam(0x08);
-    info.boardVendor = readInfoParam(0x07);
-    info.productId = readInfoParam(0x02);
-    info.vendorId = readInfoParam(0x01);
-    info.firmwareVer = readInfoParam(0x04);
-    info.productFwVer = readInfoParam(0x09);
-    info.serialNo = readInfoParam(0x03);
-    info.capabilities = getProbeDAPCap();
     info.firmwareInfo = getFirmwareInfo();
+    info.productId = info.firmwareInfo.productId;
+    info.firmwareVer = info.firmwareInfo.firmwareVersion;
+    auto payloads = readInfo({0x06, 0x05, 0x08, 0x07, 0x01, 0x09, 0x03, 0xf0, 0xfd});
+    info.targetName = infoString(payloads[0]);
+    info.targetVendor = infoString(payloads[1]);
+    info.boardName = infoString(payloads[2]);
+    info.boardVendor = infoString(payloads[3]);
+    info.vendorId = infoString(payloads[4]);
+    info.productFwVer = infoString(payloads[5]);
+    info.serialNo = infoString(payloads[6]);
+    info.capabilities = infoCapabilities(payloads[7], payloads[8]);
     return info;
 }
 
+struct DAPTarget {
+    int handle;
+    uint32_t targetSel;
+    uint32_t dpidr;
+    int designer;
+    int partNo;
+    int instance;
+    bool active;
+};
+
 uint8_t swjPinStatus(uint8_t pin, uint8_t mask) {
-    txBuffer[0] = 0x10;
-    txBuffer[1] = pin;
-    txBuffer[2] = mask;
-    UINT32_INSERT(5000, txBuffer, 3);
+    dap::put(txBuffer, dap::SWJPinsRequest(pin, mask, 5000));
     writeReadProbeData();
-    if (rxBuffer[0] != 0x10) {
+    auto response = dap::get<dap::StatusResponse>(rxBuffer, rxBufferSize);
+    if (response.command != dap::Command::SWJPins) {
         throw std::runtime_error("HIF transfer error");
     }
-    return rxBuffer[1];
+    return response.status;  // pin input state
 }
 
 void holdReset(int value) {
@@ -230,232 +355,126 @@ void holdReset(int value) {
 }
 
 int SWJSequence(int bitcount, uint8_t *data) {
-    txBuffer[0] = 0x12;
-    txBuffer[1] = static_cast<uint8_t>(bitcount >= 256 ? 0 : bitcount);
-    memcpy(&(txBuffer[2]), data, (bitcount + 7) / 8);
+    if (bitcount <= 0 || bitcount > 256) {
+        throw std::runtime_error("Invalid SWJ sequence length");
+    }
+    dap::Packet(txBuffer, txBufferSize, dap::Command::SWJSequence)
+            .u8(static_cast<uint8_t>(bitcount >= 256 ? 0 : bitcount))
+            .bytes(data, (bitcount + 7) / 8);
     writeReadProbeData();
-    if (rxBuffer[0] != 0x12) {
+    auto response = dap::get<dap::StatusResponse>(rxBuffer, rxBufferSize);
+    if (response.command != dap::Command::SWJSequence) {
         return 0x83;
-    } else if (rxBuffer[1] != 0) {
+    } else if (response.status != 0) {
         return 255;
     }
     return 0;
 }
 
-inline void WriteDPAP(int tap, uint8_t address, uint32_t data) {
-    txBuffer[0] = 0x05;
-    txBuffer[1] = tap;
-    txBuffer[2] = 1;
-    txBuffer[3] = address;
-
-    UINT32_INSERT(data, txBuffer, 4);
-
-    // wix::cout < "write: ";
-    for (int i = 0; i < 8; ++i) {
-        // wix::cout < std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(txBuffer[i]);
-    }
-    // wix::cout < " (" << data << ")" << std::endl;
-
-    writeReadProbeData();
-    if (rxBuffer[0] != 0x05) {
+// checks command echo and status byte of DAP_Connect, DAP_SWJ_Clock, DAP_TransferConfigure... responses
+inline void checkStatusResponse(dap::Command command, uint8_t status = 0) {
+    auto response = dap::get<dap::StatusResponse>(rxBuffer, rxBufferSize);
+    if (response.command != command) {
         throw std::runtime_error("HWIF transfer error");
+    } else if (response.status != status) {
+        throw std::runtime_error("Status fail");
     }
-    if (rxBuffer[2] != 0x01) {
-        if (rxBuffer[2] == 0x02) {
+}
+
+inline void checkAck(uint8_t ack) {
+    if (ack != dap::ACK_OK) {
+        if (ack == dap::ACK_WAIT) {
             throw std::runtime_error("WIRE ACK WAIT");
         } else {
             throw std::runtime_error("WIRE ACK FAULT");
         }
-    } else if (rxBuffer[1] != 1) {
+    }
+}
+
+inline void checkTransferResponse(int count) {
+    auto response = dap::get<dap::TransferResponse>(rxBuffer, rxBufferSize);
+    if (response.command != dap::Command::Transfer) {
+        throw std::runtime_error("HWIF transfer error");
+    }
+    checkAck(response.ack);
+    if (response.count != count) {
         throw std::runtime_error("Status fail");
     }
 }
 
-void WriteBlockDPAP(int tap, uint8_t address, uint32_t size, uint32_t *data) {
-    uint32_t maxRepeatBlockPayload = (512 - 5) / 4;  // packet size 512
-    uint32_t payloadPerReport;
-    uint32_t index = 0;
+inline void checkTransferBlockResponse(uint16_t count) {
+    auto response = dap::get<dap::TransferBlockResponse>(rxBuffer, rxBufferSize);
+    if (response.command != dap::Command::TransferBlock) {
+        throw std::runtime_error("HWIF transfer error");
+    }
+    checkAck(response.ack);
+    if (response.count != count) {
+        throw std::runtime_error("Status fail");
+    }
+}
 
-    //  address &= 0x0d;  // write address
+inline void WriteDPAP(int tap, dap::Port port, uint8_t address, uint32_t data) {
+    dap::Transfer(txBuffer, txBufferSize, tap).write(port, address, data);
+    writeReadProbeData();
+    checkTransferResponse(1);
+}
+
+void WriteBlockDPAP(int tap, uint8_t request, uint32_t size, const uint32_t *data) {
+    const uint32_t maxPayload = (packetSize - sizeof(dap::TransferBlockRequest)) / sizeof(uint32_t);
+    uint32_t index = 0;
 
     if (size <= 0) {
         throw std::runtime_error("Invalid block data size 1");
     }
     while (size) {
-        if (size >= maxRepeatBlockPayload) {
-            payloadPerReport = maxRepeatBlockPayload;
-        } else {
-            payloadPerReport = size;
-        }
-        txBuffer[0] = 0x06;
-        txBuffer[1] = tap;
-        UINT16_INSERT(payloadPerReport, txBuffer, 2);
-        txBuffer[4] = address;
-
-        memcpy(&txBuffer[5], &data[index], payloadPerReport * sizeof(uint32_t));
-
-        // wix::cout < "write-block: ";
-        for (int i = 0; i < payloadPerReport + 4; ++i) {
-            // wix::cout < std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(txBuffer[i]);
-        }
-        // wix::cout < std::endl;
-
+        uint32_t payload = std::min(size, maxPayload);
+        auto offset = dap::put(txBuffer, dap::TransferBlockRequest(tap, payload, request));
+        memcpy(&txBuffer[offset], &data[index], payload * sizeof(uint32_t));
         writeReadProbeData();
-
-        if (rxBuffer[0] != 0x06) {
-            throw std::runtime_error("HWIF transfer error");
-        }
-        if (rxBuffer[3] != 0x01) {  // ACK
-            if (rxBuffer[3] == 0x02) {
-                throw std::runtime_error("WIRE ACK WAIT");
-            } else {
-                throw std::runtime_error("WIRE ACK FAULT");
-            }
-        }
-        if ((rxBuffer[1] != txBuffer[2]) || (rxBuffer[2] != txBuffer[3])) {
-            throw std::runtime_error("Status fail");
-        }
-        // wix::cout < "response-block: ";
-        for (int i = 0; i < UINT16_EXTRACT(rxBuffer, 1) + 1; ++i) {
-            // wix::cout < std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(rxBuffer[i]);
-        }
-        // wix::cout < std::endl;
-        size -= payloadPerReport;
-        index += payloadPerReport;
+        checkTransferBlockResponse(payload);
+        size -= payload;
+        index += payload;
     }
 }
 
-inline uint32_t ReadDPAP(int tap, uint8_t address) {
-    txBuffer[0] = 0x05;
-    txBuffer[1] = tap;
-    txBuffer[2] = 1;
-    txBuffer[3] = address;
-
-    // wix::cout < "read-request: ";
-    //  for (int i = 0; i < 4; ++i) {
-    // wix::cout < std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(txBuffer[i]);
-    //  }
-    // wix::cout < std::endl;
+inline uint32_t ReadDPAP(int tap, dap::Port port, uint8_t address) {
+    dap::Transfer(txBuffer, txBufferSize, tap).read(port, address);
     writeReadProbeData();
-    if (rxBuffer[0] != 0x05) {
-        throw std::runtime_error("HWIF transfer error");
-    }
-    if (rxBuffer[2] != 0x01) {
-        if (rxBuffer[2] == 0x02) {
-            throw std::runtime_error("WIRE ACK WAIT");
-        } else {
-            throw std::runtime_error("WIRE ACK FAULT");
-        }
-    } else if (rxBuffer[1] != 1) {
-        throw std::runtime_error("Status fail");
-    }
-    // wix::cout < "read-data: ";
-    for (int i = 0; i < 4; ++i) {
-        // wix::cout < std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(rxBuffer[i]);
-    }
-    // wix::cout < std::endl;
-    return UINT32_EXTRACT(rxBuffer, 3);
+    checkTransferResponse(1);
+    return dap::get<dap::Le32>(rxBuffer, rxBufferSize, sizeof(dap::TransferResponse));
 }
 
-inline void ReadBlockDPAP(int tap, uint32_t address, uint32_t *size, uint32_t *data) {
-    uint32_t maxRepeatBlockPayload = (512 - 5) / 4;  // packet size 512
-    uint32_t payloadPerReport;
+inline void ReadBlockDPAP(int tap, uint8_t request, uint32_t *size, uint32_t *data) {
+    const uint32_t maxPayload = (packetSize - sizeof(dap::TransferBlockResponse)) / sizeof(uint32_t);
     uint32_t index = 0;
     if (*size <= 0) {
         throw std::runtime_error("Invalid block data size 2");
     }
     while (*size) {
-        if (*size >= maxRepeatBlockPayload) {
-            payloadPerReport = maxRepeatBlockPayload;
-        } else {
-            payloadPerReport = *size;
-        }
-        txBuffer[0] = 0x06;
-        txBuffer[1] = tap;
-        UINT16_INSERT(1, txBuffer, 2);
-        txBuffer[4] = address;
-        // wix::cout < "read-block: ";
-        for (int i = 0; i < 5; ++i) {
-            // wix::cout < std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(txBuffer[i]);
-        }
-        // wix::cout < std::endl;
+        uint32_t payload = std::min(*size, maxPayload);
+        dap::put(txBuffer, dap::TransferBlockRequest(tap, payload, request));
         writeReadProbeData();
-        if (rxBuffer[0] != 0x06) {
-            throw std::runtime_error("HWIF transfer error");
-        }
-        if (rxBuffer[3] != 0x01) {  // ACK
-            if (rxBuffer[3] == 0x02) {
-                throw std::runtime_error("WIRE ACK WAIT");
-            } else {
-                throw std::runtime_error("WIRE ACK FAULT");
-            }
-        }
-        if ((rxBuffer[1] != txBuffer[2]) || (rxBuffer[2] != txBuffer[3])) {
-            throw std::runtime_error("Status fail");
-        }
-        memcpy(&data[index], &rxBuffer[4], payloadPerReport * sizeof(uint32_t));
-        *size -= payloadPerReport;
-        index += payloadPerReport;
-        int size2 = UINT16_EXTRACT(rxBuffer, 1);
-        // wix::cout < "read-block-data (" << size2 << "): ";
-        for (int i = 0; i < size2 * sizeof(uint32_t); ++i) {
-            // wix::cout < std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(rxBuffer[4 + i]);
-        }
-        // wix::cout < std::endl;
-    }
-}
-
-std::map<std::pair<uint8_t, uint8_t>, uint8_t> REG_ADDR_TO_ID_MAP = {
-    {{0, 0x0}, 0x0},
-    {{0, 0x4}, 0x1},
-    {{0, 0x8}, 0x2},
-    {{0, 0xC}, 0x3},
-    {{1, 0x0}, 0x4},
-    {{1, 0x4}, 0x5},
-    {{1, 0x8}, 0x6},
-    {{1, 0xC}, 0x7}
-};
-
-inline uint32_t read_reg(int regID) {
-    uint8_t request = 1 << 1;
-    if (regID < 4) {
-        request |= (0 << 0);
-    } else {
-        request |= (1 << 0);
-    }
-    request |= (regID % 4) << 2;
-    return ReadDPAP(0, request);
-}
-
-inline void write_reg(uint8_t regID, uint32_t value) {
-    uint8_t request = 0 << 1;
-    if (regID < 4) {
-        request |= (0 << 0);
-    } else {
-        request |= (1 << 0);
+        checkTransferBlockResponse(payload);
+        memcpy(&data[index], &rxBuffer[sizeof(dap::TransferBlockResponse)], payload * sizeof(uint32_t));
+        *size -= payload;
+        index += payload;
     }
-    request |= (regID % 4) * 4;
-    WriteDPAP(0, request, value);
 }
 
 inline void write_ap(uint8_t address, uint32_t data) {
-    uint8_t apReg = REG_ADDR_TO_ID_MAP.at({0x01, address & 0x0000000c});  // 0x0000000c = A32
-    write_reg(apReg, data);
+    WriteDPAP(0, dap::Port::AP, address & 0x0c, data);
 }
 
 inline uint32_t read_ap(uint8_t address) {
-    uint8_t apReg = REG_ADDR_TO_ID_MAP.at({0x01, address & 0x0000000c});
-    return read_reg(apReg);
+    return ReadDPAP(0, dap::Port::AP, address & 0x0c);
 }
 
 inline uint32_t read_dp(uint8_t address) {
-    uint8_t dpReg = REG_ADDR_TO_ID_MAP.at({0x00, address});
-    return read_reg(dpReg);
+    return ReadDPAP(0, dap::Port::DP, address);
 }
 
 inline void write_dp(uint8_t address, uint32_t data) {
-    uint8_t dpReg = REG_ADDR_TO_ID_MAP.at({0x00, address});
-    write_reg(dpReg, data);
+    WriteDPAP(0, dap::Port::DP, address, data);
 }
 
 uint32_t coresight_reg_read(bool accessPort, uint32_t address);
@@ -490,6 +509,7 @@ inline void coresight_reg_write(bool accessPort, uint32_t address, uint32_t data
     //          << static_cast<int>(address) << ", data: " << data << std::endl;
     if (accessPort) {
         select_ap(address);
+        memoryCache.clear();  // target memory could change behind cache
 
         address = address & 0x0f;
         write_ap(address, data);
@@ -498,51 +518,42 @@ inline void coresight_reg_write(bool accessPort, uint32_t address, uint32_t data
     }
 }
 
-void WireConnect() {
+inline void InvalidateSelectCache() {
     last_ap = 0xffffffff;
-    txBuffer[0] = 0x02;  // Connect
-    txBuffer[1] = 1;  // 1 = swd
-    writeReadProbeData();
-    if (rxBuffer[0] != 0x02) {
-        throw std::runtime_error("HWIF transfer error");
-    } else if (rxBuffer[1] != 1) {
-        throw std::runtime_error("Status fail");
+    for (auto &target: swdTargets) {
+        target.lastAp = 0xffffffff;
     }
+}
+
+void WireConfigure() {
+    dap::put(txBuffer, dap::ConnectRequest(1));  // 1 = swd
+    writeReadProbeData();
+    checkStatusResponse(dap::Command::Connect, 1);
     wix::cout << "SWD connected" << std::endl;
 
     // SWJ clock
-    txBuffer[0] = 0x11;  // SWJ_Clock
-    UINT32_INSERT(1000000, txBuffer, 1);  // INITIAL_WIRE_SPEED 10000000, HID - 1000000
+    dap::put(txBuffer, dap::SWJClockRequest(1000000));  // INITIAL_WIRE_SPEED 10000000, HID - 1000000
     writeReadProbeData();
-    if (rxBuffer[0] != 0x11) {
-        throw std::runtime_error("HWIF transfer error");
-    } else if (rxBuffer[1] != 0) {
-        throw std::runtime_error("Status fail");
-    }
+    checkStatusResponse(dap::Command::SWJClock);
     wix::cout << "SWD clock" << std::endl;
 
-    txBuffer[0] = 0x04;
-    txBuffer[1] = 0x02;  // idle_cycles
-    UINT16_INSERT(0x0050, txBuffer, 2);
-    UINT16_INSERT(0x0000, txBuffer, 4);
+    dap::put(txBuffer, dap::TransferConfigureRequest(0x02, 0x0050, 0x0000));  // idle cycles, WAIT retry, match retry
     writeReadProbeData();
-    if (rxBuffer[0] != 0x04) {
-        throw std::runtime_error("HWIF transfer error");
-    } else if (rxBuffer[1] != 0) {
-        throw std::runtime_error("Status fail");
-    }
+    checkStatusResponse(dap::Command::TransferConfigure);
     wix::cout << "SWD transfere configured" << std::endl;
 
-    // Transfer configure
-    txBuffer[0] = 0x13;  // ?? wtf, it should be 0x04 for transfer configure, this is swd configure, transfere missing!
-    txBuffer[1] = 0x00;
+    dap::put(txBuffer, dap::SWDConfigureRequest(0x00));
     writeReadProbeData();
-    if (rxBuffer[0] != 0x13) {
-        throw std::runtime_error("HWIF transfer error");
-    } else if (rxBuffer[1] != 0) {
-        throw std::runtime_error("Status fail");
-    }
+    checkStatusResponse(dap::Command::SWDConfigure);
     wix::cout << "SWD configured" << std::endl;
+}
+
+void WireConnect() {
+    last_ap = 0xffffffff;
+    memoryCache.clear();
+    swdTargets.clear();
+    activeTarget = -1;
+    WireConfigure();
 
     // line reset
     uint8_t data[32];
@@ -552,7 +563,7 @@ void WireConnect() {
     }
     auto status = SWJSequence(bitcount, data);
 
-    UINT16_INSERT(0xE79E, data, 0)
+    dap::put(data, dap::Le16(0xe79e));  // SWD to JTAG
     status = SWJSequence(16, data);
     for (auto &index: data) {
         index = 0xff;
@@ -568,96 +579,2047 @@ void WireConnect() {
         wix::cout << "status: " << status << std::endl;
     }
 
-    uint32_t size = 25;
-    uint32_t buff[25];
-    ReadBlockDPAP(0, 0x02, &size, buff);
-    auto idr = buff[0];
+    uint32_t size = 1;
+    uint32_t idr;
+    ReadBlockDPAP(0, dap::READ<dap::Port::DP, dap::DP_DPIDR>, &size, &idr);
+    connectedDpidr = idr;
     wix::cout << "DPIDR(idr=" << std::dec << idr << ", partno=" << std::dec << static_cast<int>((idr & 0x0ff00000) >> 20)
               << ", version=" << static_cast<int>((idr & 0x0000f000) >> 12) << ", revision=" << static_cast<int>((idr & 0xf0000000) >> 28)
               << ", mindp=" << ((idr & 0x00010000) != 0 ? "true" : "false") << std::endl;
 
-    size = 25;
-    ReadBlockDPAP(0, 0x06, &size, buff);
-    wix::cout << "Checked Sticky Errors: " << std::hex << std::setw(8) << std::setfill('0') << buff[0] << std::endl;
+    size = 1;
+    uint32_t ctrlStat;
+    ReadBlockDPAP(0, dap::READ<dap::Port::DP, dap::DP_CTRL_STAT>, &size, &ctrlStat);
+    wix::cout << "Checked Sticky Errors: " << std::hex << std::setw(8) << std::setfill('0') << ctrlStat << std::endl;
 }
 
-void WireDisconnect() {
-    txBuffer[0] = 0x03;
-    writeReadProbeData();
-    if (rxBuffer[0] != 0x03) {
-        throw std::runtime_error("HIF transfer error");
-    } else if (rxBuffer[1] != 0) {
-        throw std::runtime_error("Status error");
+inline void appendSWJBits(uint8_t *data, int &bitcount, uint64_t value, int count) {
+    for (int i = 0; i < count; ++i, ++bitcount) {
+        if ((value >> i) & 1) {
+            data[bitcount / 8] |= (1 << (bitcount % 8));
+        }
     }
 }
 
-void ProbeReset() {
+void WireConnectMultiDrop() {
     last_ap = 0xffffffff;
-    txBuffer[0] = 0x81;  // ID_DAP_INFO: Vendor1
-    txBuffer[1] = 0;  // 1 for ISP reset
+    memoryCache.clear();
+    swdTargets.clear();
+    activeTarget = -1;
+    WireConfigure();
+
+    // DPv2 targets could sleep in dormant state, so wake up all of them and switch to SWD, see ADIv5.2 B5.3
+    uint8_t data[32] = {};
+    int bitcount = 0;
+    appendSWJBits(data, bitcount, 0x7ffffffffffffULL, 51);  // line reset
+    appendSWJBits(data, bitcount, 0x33bbbbba, 31);  // JTAG to dormant
+    appendSWJBits(data, bitcount, 0xff, 8);
+    appendSWJBits(data, bitcount, 0x86852d956209f392ULL, 64);  // selection alert
+    appendSWJBits(data, bitcount, 0x19bc0ea2e3ddafe9ULL, 64);
+    auto status = SWJSequence(bitcount, data);
+
+    memset(data, 0, sizeof(data));
+    bitcount = 0;
+    appendSWJBits(data, bitcount, 0x1a0, 12);  // 4 idle cycles + SWD activation code
+    appendSWJBits(data, bitcount, 0x7ffffffffffffULL, 51);  // line reset
+    appendSWJBits(data, bitcount, 0x00, 8);
+    status |= SWJSequence(bitcount, data);
+    if (status) {
+        throw std::runtime_error("Multi-drop wake-up sequence failed");
+    }
+    wix::cout << "SWD multi-drop bus ready" << std::endl;
+}
+
+// TARGETSEL write is not acknowledged by any target, so it can't go over DAP_Transfer and whole selection is sent
+// as one DAP_SWD_Sequence. Line reset is mandatory before TARGETSEL and DPIDR read right after it.
+inline uint32_t SWDSelectTarget(uint32_t targetSel) {
+    dap::Packet(txBuffer, txBufferSize, dap::Command::SWDSequence)
+            .u8(6)  // sequence count
+            .u8(56)  // line reset
+            .fill(0xff, 7)
+            .u8(8)  // idle
+            .u8(0x00)
+            .u8(8)  // request: start, DP, write, A[3:2]=0b11, parity, stop, park
+            .u8(0x99)
+            .u8(0x80 | 5)  // turnaround, ACK (ignored), turnaround
+            .u8(33)  // data + parity
+            .u32(targetSel)
+            .u8(__builtin_parity(targetSel))
+            .u8(2)  // idle
+            .u8(0x00);
     writeReadProbeData();
-    if (rxBuffer[0] != 0x81) {
-        throw std::runtime_error("HIF transfer error");
-    } else if (rxBuffer[1] != 0) {
-        throw std::runtime_error("REDLINK status fail");
-    } else if (rxBuffer[2] <= 0) {
-        throw std::runtime_error("REDLINK status fail 2");
+    auto response = dap::get<dap::StatusResponse>(rxBuffer, rxBufferSize);
+    if (response.command != dap::Command::SWDSequence) {
+        throw std::runtime_error("SWD sequence is not supported by probe");
+    } else if (response.status != 0) {
+        throw std::runtime_error("Status fail");
     }
+    return ReadDPAP(0, dap::Port::DP, dap::DP_DPIDR);
 }
 
-void Reset() {
+void SelectTarget(int handle) {
+    if (handle < 0 || handle >= static_cast<int>(swdTargets.size())) {
+        throw std::runtime_error("Invalid target handle");
+    }
+    if (handle == activeTarget) {
+        return;
+    }
+    if (activeTarget >= 0) {
+        swdTargets[activeTarget].lastAp = last_ap;
+    }
+    activeTarget = -1;
     last_ap = 0xffffffff;
-    wix::cout << "Reset target" << std::endl;
-    holdReset(0);
-    emscripten_sleep(50 - 3);  // -3ms for USB latency
-    holdReset(1);
+    memoryCache.clear();
+
+    auto &target = swdTargets[handle];
+    if (SWDSelectTarget(target.targetSel) != target.dpidr) {
+        throw std::runtime_error("Target DPIDR mismatch");
+    }
+    activeTarget = handle;
+    last_ap = target.lastAp;
+    connectedDpidr = target.dpidr;
 }
 
-// @formatter:off
-EMSCRIPTEN_BINDINGS(module) {
-    /** General API **/
-    emscripten::value_object<DAPCapabilities>("DAPCapabilities")
-            .field("swd", &DAPCapabilities::swd)
-            .field("jtag", &DAPCapabilities::jtag)
-            .field("manchester", &DAPCapabilities::manchester)
-            .field("swoTraceBufferSize", &DAPCapabilities::swoTraceBufferSize)
-            .field("atomic", &DAPCapabilities::atomic)
-            .field("swoStreaming", &DAPCapabilities::swoStreaming);
+int AddTarget(uint32_t targetSel) {
+    for (size_t i = 0; i < swdTargets.size(); ++i) {
+        if (swdTargets[i].targetSel == targetSel) {
+            SelectTarget(static_cast<int>(i));
+            return static_cast<int>(i);
+        }
+    }
+    if (activeTarget >= 0) {
+        swdTargets[activeTarget].lastAp = last_ap;
+    }
+    activeTarget = -1;
+    last_ap = 0xffffffff;
+    memoryCache.clear();
+
+    auto dpidr = SWDSelectTarget(targetSel);
+    swdTargets.push_back({targetSel, dpidr, 0xffffffff});
+    activeTarget = static_cast<int>(swdTargets.size() - 1);
+    connectedDpidr = dpidr;
+    wix::cout << "Target " << activeTarget << " added (targetsel=" << std::hex << std::setw(8) << std::setfill('0') << targetSel
+              << ", dpidr=" << std::setw(8) << dpidr << ")" << std::endl;
+    return activeTarget;
+}
 
-    emscripten::value_object<DAPFirmwareInfo>("getFirmwareInfo")
-            .field("firmwareVersion", &DAPFirmwareInfo::firmwareVersion)
-            .field("productId", &DAPFirmwareInfo::productId)
-            .field("maxPacketCount", &DAPFirmwareInfo::maxPacketCount)
-            .field("maxPacketSize", &DAPFirmwareInfo::maxPacketSize);
+int GetTargetCount() {
+    return static_cast<int>(swdTargets.size());
+}
 
-    emscripten::value_object<DAPInfo>("DAPInfo")
-            .field("vendorId", &DAPInfo::vendorId)
-            .field("productId", &DAPInfo::productId)
-            .field("serialNo", &DAPInfo::serialNo)
-            .field("firmwareVer", &DAPInfo::firmwareVer)
-            .field("targetVendor", &DAPInfo::targetVendor)
-            .field("targetName", &DAPInfo::targetName)
-            .field("boardVendor", &DAPInfo::boardVendor)
-            .field("boardName", &DAPInfo::boardName)
-            .field("productFwVer", &DAPInfo::productFwVer)
-            .field("capabilities", &DAPInfo::capabilities)
-            .field("firmwareInfo", &DAPInfo::firmwareInfo);
-    emscripten::function("getProbeDAPInfo", &getProbeDAPInfo);
-    emscripten::function("getSupportedVendorIDs", &getSupportedVendorIDs);
-    emscripten::function("reset", &Reset);
-    emscripten::function("probeReset", &ProbeReset);
+DAPTarget GetTargetInfo(int handle) {
+    if (handle < 0 || handle >= static_cast<int>(swdTargets.size())) {
+        throw std::runtime_error("Invalid target handle");
+    }
+    const auto &target = swdTargets[handle];
+    DAPTarget info{};
+    info.handle = handle;
+    info.targetSel = target.targetSel;
+    info.dpidr = target.dpidr;
+    info.designer = static_cast<int>((target.targetSel >> 1) & 0x7ff);
+    info.partNo = static_cast<int>((target.targetSel >> 12) & 0xffff);
+    info.instance = static_cast<int>(target.targetSel >> 28);
+    info.active = handle == activeTarget;
+    return info;
+}
 
-    /** Debugger API **/
-    emscripten::function("connect", WireConnect);
-    emscripten::function("disconnect", WireDisconnect);
-    emscripten::function("coreSightRead", coresight_reg_read);
-    emscripten::function("coreSightWrite", coresight_reg_write);
+// CoreSight discovery, builds typed component map from AP list and ROM tables
+enum class CoreSightType : int {
+    Unknown = 0,
+    RomTable,
+    SCS,
+    DWT,
+    FPB,
+    ITM,
+    ETM,
+    TPIU,
+    CTI,
+    MTB
+};
+
+const char *CORESIGHT_TYPE_NAMES[] = {"UNKNOWN", "ROM", "SCS", "DWT", "FPB", "ITM", "ETM", "TPIU", "CTI", "MTB"};
+
+struct AccessPortInfo {
+    uint8_t apsel;
+    uint32_t idr;
+    uint32_t base;
+};
+
+struct CoreSightComponent {
+    uint8_t apsel;
+    uint32_t address;
+    CoreSightType type;
+    uint16_t partNo;
+    uint16_t designer;
+};
+
+struct ComponentMap {
+    bool valid;
+    uint32_t dpidr;
+    std::string targetName;
+    std::vector<AccessPortInfo> aps;
+    std::vector<CoreSightComponent> components;
+};
+
+ComponentMap componentMap{};
+
+const uint16_t ARM_DESIGNER = 0x43b;
+const uint32_t MEM_AP_CSW = 0x22000012;  // 32-bit access, single auto increment
+const uint32_t MEM_AP_CSW_BYTE = 0x22000010;  // 8-bit access, single auto increment
+
+inline bool isMemAP(uint32_t idr) {
+    return ((idr >> 13) & 0x0f) == 8;
+}
+
+// Reads words over MEM-AP in one DAP_Transfer (CSW, TAR and DRW reads), TAR auto increment wraps at 1kB boundary
+void MemAPReadBlock(uint8_t apsel, uint32_t address, uint32_t *data, int count) {
+    if (count <= 0 || ((address & 0x3ff) + count * 4) > 0x400) {
+        throw std::runtime_error("Invalid MEM-AP block read size");
+    }
+    select_ap(static_cast<uint32_t>(apsel) << 24);
+    dap::Transfer transfer(txBuffer, txBufferSize);
+    transfer.write<dap::Port::AP, dap::AP_CSW>(MEM_AP_CSW).write<dap::Port::AP, dap::AP_TAR>(address);
+    for (int i = 0; i < count; ++i) {
+        transfer.read<dap::Port::AP, dap::AP_DRW>();
+    }
+    writeReadProbeData();
+    checkTransferResponse(transfer.count());
+    for (int i = 0; i < count; ++i) {
+        data[i] = dap::get<dap::Le32>(rxBuffer, rxBufferSize, sizeof(dap::TransferResponse) + i * 4);
+    }
+}
+
+inline void clearStickyErrors() {
+    coresight_reg_write(false, 0x00, 0x1e);  // ABORT: STKCMPCLR | STKERRCLR | WDERRCLR | ORUNERRCLR
 }
-// @formatter:on
-#else
 
-int main() {
-    // wix::cout < "Hello from dapper CLI interface! There is nothing to dapperize yet, please come back and try me later :-)" << std::endl;
+CoreSightType identifyComponent(uint8_t apsel, uint32_t address, uint8_t cidrClass, uint16_t designer, uint16_t partNo) {
+    if (cidrClass == 0x1) {
+        return CoreSightType::RomTable;
+    }
+    if (cidrClass == 0x9) {
+        uint32_t devarch;
+        MemAPReadBlock(apsel, address + 0xfbc, &devarch, 1);
+        if ((devarch >> 21) == 0x23b && (devarch & (1 << 20))) {  // architect ARM, present
+            switch (devarch & 0xffff) {
+                case 0x0af7:
+                    return CoreSightType::RomTable;
+                case 0x1a01:
+                    return CoreSightType::ITM;
+                case 0x1a02:
+                    return CoreSightType::DWT;
+                case 0x1a03:
+                    return CoreSightType::FPB;
+                case 0x2a04:
+                    return CoreSightType::SCS;
+                case 0x4a13:
+                    return CoreSightType::ETM;
+                case 0x1a14:
+                    return CoreSightType::CTI;
+                case 0x0a31:
+                    return CoreSightType::MTB;
+            }
+        }
+    }
+    if (designer == ARM_DESIGNER) {
+        switch (partNo) {
+            case 0x000:
+            case 0x008:
+            case 0x00c:
+                return CoreSightType::SCS;
+            case 0x002:
+            case 0x00a:
+                return CoreSightType::DWT;
+            case 0x003:
+            case 0x00b:
+            case 0x00e:
+                return CoreSightType::FPB;
+            case 0x001:
+                return CoreSightType::ITM;
+            case 0x924:
+            case 0x925:
+            case 0x975:
+                return CoreSightType::ETM;
+            case 0x923:
+            case 0x9a1:
+            case 0x9a9:
+                return CoreSightType::TPIU;
+            case 0x906:
+                return CoreSightType::CTI;
+            case 0x932:
+                return CoreSightType::MTB;
+        }
+    }
+    // Cortex-M private peripheral bus layout as fallback for vendor specific part numbers
+    switch (address) {
+        case 0xe000e000:
+            return CoreSightType::SCS;
+        case 0xe0001000:
+            return CoreSightType::DWT;
+        case 0xe0002000:
+            return CoreSightType::FPB;
+        case 0xe0000000:
+            return CoreSightType::ITM;
+        case 0xe0041000:
+            return CoreSightType::ETM;
+        case 0xe0040000:
+            return CoreSightType::TPIU;
+    }
+    return CoreSightType::Unknown;
 }
 
+void walkRomTable(uint8_t apsel, uint32_t base, int depth) {
+    uint32_t ids[12];  // PIDR4-7, PIDR0-3, CIDR0-3
+    MemAPReadBlock(apsel, base + 0xfd0, ids, 12);
+    uint8_t cidrClass = (ids[9] >> 4) & 0x0f;
+    if ((ids[8] & 0xff) != 0x0d || (ids[10] & 0xff) != 0x05 || (ids[11] & 0xff) != 0xb1) {
+        wix::cout << "No CoreSight component at 0x" << std::hex << base << std::endl;
+        return;
+    }
+    uint16_t designer = ((ids[0] & 0x0f) << 8) | ((ids[6] & 0x07) << 4) | ((ids[5] >> 4) & 0x0f);
+    uint16_t partNo = ((ids[5] & 0x0f) << 8) | (ids[4] & 0xff);
+    auto type = identifyComponent(apsel, base, cidrClass, designer, partNo);
+    componentMap.components.push_back({apsel, base, type, partNo, designer});
+    wix::cout << "AP" << std::dec << static_cast<int>(apsel) << " component " << CORESIGHT_TYPE_NAMES[static_cast<int>(type)]
+              << " at 0x" << std::hex << std::setw(8) << std::setfill('0') << base << std::endl;
+
+    if (type != CoreSightType::RomTable || depth > 4) {
+        return;
+    }
+    // class 0x1 table has up to 960 entries with present bit 0, class 0x9 table up to 512 words of entries with
+    // PRESENT in bits [1:0] (0b11 present, 0b10 skipped, 0b00 end) and DEVID.FORMAT selecting 32 or 64 bit entries
+    bool class9 = cidrClass == 0x9;
+    int limit = class9 ? 512 : 960;
+    int stride = 1;
+    if (class9) {
+        uint32_t devid;
+        MemAPReadBlock(apsel, base + 0xfcc, &devid, 1);
+        stride = (devid & 0x0f) == 1 ? 2 : 1;  // upper word of 64 bit entry is zero in 32 bit address space
+    }
+    const int chunk = 15;
+    uint32_t entries[chunk];
+    for (int index = 0, count; index < limit; index += count) {
+        uint32_t entryAddress = base + index * 4;
+        count = std::min({chunk, limit - index, static_cast<int>((0x400 - (entryAddress & 0x3ff)) / 4)});
+        MemAPReadBlock(apsel, entryAddress, entries, count);
+        for (int i = index % stride; i < count; i += stride) {
+            uint32_t present = class9 ? entries[i] & 0x3 : entries[i] & 0x1;
+            if (entries[i] == 0 || (class9 && present == 0)) {
+                return;
+            }
+            if (present != (class9 ? 0x3u : 0x1u)) {
+                continue;
+            }
+            uint32_t address = base + (entries[i] & 0xfffff000);
+            try {
+                walkRomTable(apsel, address, depth + 1);
+            } catch (const std::runtime_error &ex) {
+                wix::cout << "Component at 0x" << std::hex << address << " is not accessible: " << ex.what() << std::endl;
+                clearStickyErrors();
+            }
+        }
+    }
+}
+
+std::string SerializeComponentMap() {
+    std::ostringstream stream;
+    stream << "dapper-components 2\n";
+    stream << "dpidr " << std::hex << componentMap.dpidr << "\n";
+    // length prefixed, probe could report empty name or name with spaces
+    stream << "target " << std::dec << componentMap.targetName.size() << " " << componentMap.targetName << "\n";
+    for (const auto &ap: componentMap.aps) {
+        stream << "ap " << std::dec << static_cast<int>(ap.apsel) << " " << std::hex << ap.idr << " " << ap.base << "\n";
+    }
+    for (const auto &component: componentMap.components) {
+        stream << "component " << std::dec << static_cast<int>(component.apsel) << " " << std::hex << component.address << " "
+               << CORESIGHT_TYPE_NAMES[static_cast<int>(component.type)] << " " << component.partNo << " " << component.designer << "\n";
+    }
+    return stream.str();
+}
+
+std::string DiscoverComponents(const std::string &targetName) {
+    componentMap = {};
+    componentMap.dpidr = coresight_reg_read(false, 0x00);
+    componentMap.targetName = targetName;
+
+    int emptyRun = 0;
+    for (int apsel = 0; apsel < 256 && emptyRun < 2; ++apsel) {
+        uint32_t idr = 0;
+        try {
+            idr = coresight_reg_read(true, (static_cast<uint32_t>(apsel) << 24) | 0xfc);
+        } catch (const std::runtime_error &) {
+            clearStickyErrors();
+        }
+        if (idr == 0) {
+            emptyRun++;
+            continue;
+        }
+        emptyRun = 0;
+        AccessPortInfo ap{static_cast<uint8_t>(apsel), idr, 0};
+        if (isMemAP(idr)) {
+            ap.base = coresight_reg_read(true, (static_cast<uint32_t>(apsel) << 24) | 0xf8);
+            if (ap.base != 0xffffffff && (ap.base & 0x1)) {
+                try {
+                    walkRomTable(ap.apsel, ap.base & 0xfffff000, 0);
+                } catch (const std::runtime_error &ex) {
+                    wix::cout << "ROM table of AP" << std::dec << apsel << " is not accessible: " << ex.what() << std::endl;
+                    clearStickyErrors();
+                }
+            }
+        }
+        componentMap.aps.push_back(ap);
+    }
+    componentMap.valid = true;
+    return SerializeComponentMap();
+}
+
+// Restores map from previous session, validated by DPIDR and IDR of the first AP in one DAP_Transfer
+bool RestoreComponents(const std::string &data) {
+    ComponentMap restored{};
+    std::istringstream stream(data);
+    std::string line;
+    std::getline(stream, line);
+    if (line != "dapper-components 2") {
+        return false;
+    }
+    while (std::getline(stream, line)) {
+        std::istringstream fields(line);
+        std::string key;
+        fields >> key;
+        if (key == "dpidr") {
+            fields >> std::hex >> restored.dpidr;
+        } else if (key == "target") {
+            std::size_t length = 0;
+            fields >> std::dec >> length;
+            fields.get();  // separator
+            if (length > line.size()) {
+                return false;
+            }
+            restored.targetName.resize(length);
+            fields.read(&restored.targetName[0], static_cast<std::streamsize>(length));
+        } else if (key == "ap") {
+            int apsel;
+            AccessPortInfo ap{};
+            fields >> std::dec >> apsel >> std::hex >> ap.idr >> ap.base;
+            ap.apsel = static_cast<uint8_t>(apsel);
+            restored.aps.push_back(ap);
+        } else if (key == "component") {
+            int apsel;
+            std::string typeName;
+            CoreSightComponent component{};
+            fields >> std::dec >> apsel >> std::hex >> component.address >> typeName >> component.partNo >> component.designer;
+            component.apsel = static_cast<uint8_t>(apsel);
+            for (int i = 0; i < static_cast<int>(sizeof(CORESIGHT_TYPE_NAMES) / sizeof(CORESIGHT_TYPE_NAMES[0])); ++i) {
+                if (typeName == CORESIGHT_TYPE_NAMES[i]) {
+                    component.type = static_cast<CoreSightType>(i);
+                }
+            }
+            restored.components.push_back(component);
+        }
+        if (fields.fail()) {
+            return false;
+        }
+    }
+
+    dap::Transfer transfer(txBuffer, txBufferSize);
+    transfer.read<dap::Port::DP, dap::DP_DPIDR>();
+    uint32_t select = 0;
+    if (!restored.aps.empty()) {
+        select = (static_cast<uint32_t>(restored.aps[0].apsel) << 24) | 0xf0;
+        transfer.write<dap::Port::DP, dap::DP_SELECT>(select).read<dap::Port::AP, 0x0c>();  // AP IDR
+    }
+    writeReadProbeData();
+    auto response = dap::get<dap::TransferResponse>(rxBuffer, rxBufferSize);
+    if (response.command != dap::Command::Transfer) {
+        throw std::runtime_error("HWIF transfer error");
+    }
+    if (transfer.count() == 3) {
+        last_ap = response.count >= 2 ? select : 0xffffffff;
+    }
+    if (response.ack != dap::ACK_OK || response.count != transfer.count()) {
+        clearStickyErrors();
+        return false;
+    }
+    auto dpidr = dap::get<dap::Le32>(rxBuffer, rxBufferSize, 3);
+    if (dpidr != restored.dpidr || (transfer.count() == 3 && dap::get<dap::Le32>(rxBuffer, rxBufferSize, 7) != restored.aps[0].idr)) {
+        return false;
+    }
+    restored.valid = true;
+    componentMap = restored;
+    return true;
+}
+
+std::string ComponentMapKey(const std::string &targetName) {
+    std::ostringstream stream;
+    stream << std::hex << std::setw(8) << std::setfill('0') << connectedDpidr;
+    if (activeTarget >= 0) {
+        stream << "-" << std::setw(8) << swdTargets[activeTarget].targetSel;
+    }
+    stream << ":" << targetName;
+    return stream.str();
+}
+
+const CoreSightComponent *findComponent(CoreSightType type) {
+    for (const auto &component: componentMap.components) {
+        if (component.type == type) {
+            return &component;
+        }
+    }
+    return nullptr;
+}
+
+// Returns MEM-AP with core debug (SCS) behind it or first MEM-AP when none
+int GetMemAP() {
+    if (const auto *scs = findComponent(CoreSightType::SCS)) {
+        return scs->apsel;
+    }
+    for (const auto &ap: componentMap.aps) {
+        if (isMemAP(ap.idr)) {
+            return ap.apsel;
+        }
+    }
+    return -1;
+}
+
+// Reads words over MEM-AP with DAP_TransferBlock, TAR is written again at every 1kB auto increment boundary
+void MemAPReadWords(uint8_t apsel, uint32_t address, uint32_t *data, uint32_t count) {
+    select_ap(static_cast<uint32_t>(apsel) << 24);
+    while (count) {
+        uint32_t chunk = std::min(count, (0x400 - (address & 0x3ff)) / 4);
+        dap::Transfer transfer(txBuffer, txBufferSize);
+        transfer.write<dap::Port::AP, dap::AP_CSW>(MEM_AP_CSW).write<dap::Port::AP, dap::AP_TAR>(address);
+        writeReadProbeData();
+        checkTransferResponse(transfer.count());
+        uint32_t size = chunk;
+        ReadBlockDPAP(0, dap::READ<dap::Port::AP, dap::AP_DRW>, &size, data);
+        address += chunk * 4;
+        data += chunk;
+        count -= chunk;
+    }
+}
+
+// Reads up to 3 bytes of one word with byte accesses in one DAP_Transfer, data come on their byte lanes
+void MemAPReadWordBytes(uint8_t apsel, uint32_t address, uint8_t *data, uint32_t size) {
+    if (size == 0) {
+        return;
+    }
+    select_ap(static_cast<uint32_t>(apsel) << 24);
+    dap::Transfer transfer(txBuffer, txBufferSize);
+    transfer.write<dap::Port::AP, dap::AP_CSW>(MEM_AP_CSW_BYTE).write<dap::Port::AP, dap::AP_TAR>(address);
+    for (uint32_t i = 0; i < size; i++) {
+        transfer.read<dap::Port::AP, dap::AP_DRW>();
+    }
+    writeReadProbeData();
+    checkTransferResponse(transfer.count());
+    for (uint32_t i = 0; i < size; i++) {
+        uint32_t word = dap::get<dap::Le32>(rxBuffer, rxBufferSize, sizeof(dap::TransferResponse) + i * sizeof(dap::Le32));
+        data[i] = static_cast<uint8_t>(word >> (8 * ((address + i) & 0x03)));
+    }
+}
+
+// Reads bytes at any alignment, unaligned head and tail use byte accesses so nothing outside of the range is read
+void MemAPReadBytes(uint8_t apsel, uint32_t address, uint8_t *data, uint32_t size) {
+    uint32_t head = std::min(size, (4 - (address & 0x03)) & 0x03);
+    uint32_t count = (size - head) / 4;
+    uint32_t tail = size - head - count * 4;
+    MemAPReadWordBytes(apsel, address, data, head);
+    if (count) {
+        std::vector<uint32_t> words(count);
+        MemAPReadWords(apsel, address + head, words.data(), count);
+        for (uint32_t i = 0; i < count; i++) {
+            dap::put(data + head + 4 * i, dap::Le32(words[i]));
+        }
+    }
+    MemAPReadWordBytes(apsel, address + head + count * 4, data + head + count * 4, tail);
+}
+
+// page cache policy follows memory regions defined below, RTT and profiler writes keep cached pages consistent
+void memoryCacheWritten(uint32_t address, uint32_t size);
+
+// RTT (SEGGER RTT compatible) ring buffers, control block is searched once and ring descriptors stay cached
+struct RttChannel {
+    std::string name;
+    uint32_t descriptor;
+    uint32_t buffer;
+    uint32_t size;
+    uint32_t rdOff;
+    std::vector<uint8_t> pending;
+};
+
+struct RttControlBlock {
+    bool valid;
+    uint8_t apsel;
+    uint32_t address;
+    uint32_t start;  // search range, control block is found there again when target moves it
+    uint32_t size;
+    std::vector<RttChannel> up;
+    std::vector<RttChannel> down;
+};
+
+struct RttChannelInfo {
+    int index;
+    std::string name;
+    int bufferSize;
+    bool up;
+};
+
+RttControlBlock rtt{};
+std::vector<uint8_t> rttReadBuffer;
+
+const char RTT_ID[] = "SEGGER RTT";
+const uint32_t RTT_ID_SIZE = 16;
+const uint32_t RTT_DESCRIPTOR_SIZE = 24;  // sName, pBuffer, SizeOfBuffer, WrOff, RdOff, Flags
+const uint32_t RTT_MAX_CHANNELS = 32;
+const uint32_t RTT_NAME_SIZE = 32;
+
+uint32_t findRttControlBlock(uint8_t apsel, uint32_t start, uint32_t size) {
+    const std::size_t idLength = sizeof(RTT_ID) - 1;
+    std::vector<uint32_t> words(0x400 / 4);
+    std::string window;
+    uint32_t windowAddress = start;
+    for (uint32_t offset = 0; offset < size; offset += 0x400) {
+        uint32_t count = std::min<uint32_t>(0x400, size - offset) / 4;
+        MemAPReadWords(apsel, start + offset, words.data(), count);
+        window.append(reinterpret_cast<const char *>(words.data()), count * 4);
+        auto position = window.find(RTT_ID, 0, idLength);
+        if (position != std::string::npos) {
+            return windowAddress + static_cast<uint32_t>(position);
+        }
+        // ID can be split by chunk boundary
+        std::size_t keep = std::min(window.size(), idLength - 1);
+        windowAddress += static_cast<uint32_t>(window.size() - keep);
+        window.erase(0, window.size() - keep);
+    }
+    throw std::runtime_error("RTT control block not found");
+}
+
+bool checkRttControlBlock() {
+    if (!rtt.valid) {
+        return false;
+    }
+    char id[RTT_ID_SIZE];
+    MemAPReadBytes(rtt.apsel, rtt.address, reinterpret_cast<uint8_t *>(id), RTT_ID_SIZE);
+    return std::strncmp(id, RTT_ID, sizeof(RTT_ID) - 1) == 0;
+}
+
+std::vector<RttChannel> readRttChannels(uint32_t address, uint32_t count) {
+    std::vector<RttChannel> channels(count);
+    if (count == 0) {
+        return channels;
+    }
+    std::vector<uint32_t> descriptors(count * RTT_DESCRIPTOR_SIZE / 4);
+    MemAPReadWords(rtt.apsel, address, descriptors.data(), static_cast<uint32_t>(descriptors.size()));
+    for (uint32_t i = 0; i < count; i++) {
+        const uint32_t *descriptor = &descriptors[i * RTT_DESCRIPTOR_SIZE / 4];
+        auto &channel = channels[i];
+        channel.descriptor = address + i * RTT_DESCRIPTOR_SIZE;
+        channel.buffer = descriptor[1];
+        channel.size = descriptor[2];
+        channel.rdOff = descriptor[4];
+        if (descriptor[0] != 0) {
+            char name[RTT_NAME_SIZE];
+            MemAPReadBytes(rtt.apsel, descriptor[0], reinterpret_cast<uint8_t *>(name), RTT_NAME_SIZE);
+            channel.name.assign(name, strnlen(name, RTT_NAME_SIZE));
+        }
+    }
+    return channels;
+}
+
+// Finds control block in RAM range (or validates cached one) and reads ring descriptors, returns up channel count
+int RttStart(int apsel, uint32_t start, uint32_t size) {
+    if (apsel < 0) {
+        apsel = GetMemAP();
+        if (apsel < 0) {
+            throw std::runtime_error("MEM-AP is not known, discover components first");
+        }
+    }
+    if (!(rtt.valid && rtt.apsel == apsel && rtt.address >= start && rtt.address < start + size && checkRttControlBlock())) {
+        rtt = {};
+        rtt.apsel = static_cast<uint8_t>(apsel);
+        rtt.address = findRttControlBlock(rtt.apsel, start, size);
+    }
+    uint32_t header[2];
+    MemAPReadWords(rtt.apsel, rtt.address + RTT_ID_SIZE, header, 2);
+    if (header[0] > RTT_MAX_CHANNELS || header[1] > RTT_MAX_CHANNELS) {
+        rtt.valid = false;
+        throw std::runtime_error("Invalid RTT control block");
+    }
+    uint32_t upAddress = rtt.address + RTT_ID_SIZE + sizeof(header);
+    rtt.up = readRttChannels(upAddress, header[0]);
+    rtt.down = readRttChannels(upAddress + header[0] * RTT_DESCRIPTOR_SIZE, header[1]);
+    rtt.start = start;
+    rtt.size = size;
+    rtt.valid = true;
+    wix::cout << "RTT control block at 0x" << std::hex << rtt.address << std::dec << ", up: " << header[0] << ", down: " << header[1]
+              << std::endl;
+    return static_cast<int>(rtt.up.size());
+}
+
+int RttGetChannelCount() {
+    return static_cast<int>(rtt.up.size());
+}
+
+RttChannelInfo RttGetChannelInfo(int index) {
+    if (index < 0 || index >= static_cast<int>(rtt.up.size())) {
+        throw std::runtime_error("Invalid RTT channel");
+    }
+    return {index, rtt.up[index].name, static_cast<int>(rtt.up[index].size), true};
+}
+
+// Reads WrOff and RdOff of all up channels, both offsets of a channel are taken by one auto increment pair of DRW reads
+void readRttOffsets(std::vector<uint32_t> &wrOffs, std::vector<uint32_t> &rdOffs) {
+    select_ap(static_cast<uint32_t>(rtt.apsel) << 24);
+    wrOffs.resize(rtt.up.size());
+    rdOffs.resize(rtt.up.size());
+    for (std::size_t next = 0; next < rtt.up.size();) {
+        std::size_t first = next;
+        dap::Transfer transfer(txBuffer, txBufferSize);
+        transfer.write<dap::Port::AP, dap::AP_CSW>(MEM_AP_CSW);
+        while (next < rtt.up.size() && transfer.fits(4, 2, 2)) {
+            uint32_t wrOffAddress = rtt.up[next].descriptor + 12;
+            transfer.write<dap::Port::AP, dap::AP_TAR>(wrOffAddress).read<dap::Port::AP, dap::AP_DRW>();
+            if (((wrOffAddress + 4) & 0x3ff) == 0) {
+                transfer.write<dap::Port::AP, dap::AP_TAR>(wrOffAddress + 4);  // auto increment does not cross 1 kB
+            }
+            transfer.read<dap::Port::AP, dap::AP_DRW>();
+            next++;
+        }
+        writeReadProbeData();
+        checkTransferResponse(transfer.count());
+        for (std::size_t i = first; i < next; i++) {
+            std::size_t offset = sizeof(dap::TransferResponse) + (i - first) * 2 * sizeof(dap::Le32);
+            wrOffs[i] = dap::get<dap::Le32>(rxBuffer, rxBufferSize, offset);
+            rdOffs[i] = dap::get<dap::Le32>(rxBuffer, rxBufferSize, offset + sizeof(dap::Le32));
+        }
+    }
+}
+
+// Control block is validated again (and searched when it is gone), received but not yet read data are kept
+void resyncRttControlBlock() {
+    std::vector<std::vector<uint8_t>> pending;
+    for (auto &channel: rtt.up) {
+        pending.push_back(std::move(channel.pending));
+    }
+    RttStart(rtt.apsel, rtt.start, rtt.size);
+    for (std::size_t i = 0; i < pending.size() && i < rtt.up.size(); i++) {
+        rtt.up[i].pending = std::move(pending[i]);
+    }
+}
+
+// Polls write and read offsets of all up channels in one DAP_Transfer, reads only new bytes and moves all read offsets
+// together. Read offset changed behind our back (firmware restarted RTT, another reader) triggers control block
+// resync, offsets of still valid control block are then taken from target.
+int RttPoll() {
+    if (!rtt.valid) {
+        throw std::runtime_error("RTT is not started");
+    }
+    std::vector<uint32_t> wrOffs;
+    std::vector<uint32_t> rdOffs;
+    readRttOffsets(wrOffs, rdOffs);
+    bool changed = false;
+    for (std::size_t i = 0; i < rtt.up.size(); i++) {
+        changed = changed || rdOffs[i] != rtt.up[i].rdOff;
+    }
+    if (changed) {
+        wix::cout << "RTT read offset was changed by target, control block is read again" << std::endl;
+        resyncRttControlBlock();
+        readRttOffsets(wrOffs, rdOffs);
+        for (std::size_t i = 0; i < rtt.up.size(); i++) {
+            rtt.up[i].rdOff = rdOffs[i];
+        }
+    }
+
+    int total = 0;
+    std::vector<std::size_t> consumed;
+    for (std::size_t i = 0; i < rtt.up.size(); i++) {
+        auto &channel = rtt.up[i];
+        uint32_t wrOff = wrOffs[i];
+        if (wrOff >= channel.size || channel.rdOff >= channel.size) {
+            rtt.valid = false;
+            throw std::runtime_error("RTT ring offsets out of range");
+        }
+        if (wrOff == channel.rdOff) {
+            continue;
+        }
+        uint32_t tail = wrOff > channel.rdOff ? wrOff - channel.rdOff : channel.size - channel.rdOff;
+        std::size_t offset = channel.pending.size();
+        channel.pending.resize(offset + tail + (wrOff < channel.rdOff ? wrOff : 0));
+        MemAPReadBytes(rtt.apsel, channel.buffer + channel.rdOff, &channel.pending[offset], tail);
+        if (wrOff < channel.rdOff) {
+            MemAPReadBytes(rtt.apsel, channel.buffer, &channel.pending[offset + tail], wrOff);
+        }
+        total += static_cast<int>(channel.pending.size() - offset);
+        channel.rdOff = wrOff;
+        consumed.push_back(i);
+    }
+
+    // DAP_TransferBlock carrying ring data takes no other requests, so read offsets of all channels go in one DAP_Transfer
+    for (std::size_t next = 0; next < consumed.size();) {
+        dap::Transfer transfer(txBuffer, txBufferSize);
+        transfer.write<dap::Port::AP, dap::AP_CSW>(MEM_AP_CSW);
+        while (next < consumed.size() && transfer.fits(2, 2, 0)) {
+            const auto &channel = rtt.up[consumed[next]];
+            memoryCacheWritten(channel.descriptor + 16, sizeof(uint32_t));
+            transfer.write<dap::Port::AP, dap::AP_TAR>(channel.descriptor + 16).write<dap::Port::AP, dap::AP_DRW>(channel.rdOff);
+            next++;
+        }
+        writeReadProbeData();
+        checkTransferResponse(transfer.count());
+    }
+    return total;
+}
+
+// Returns bytes received on up channel since last call, view is valid until next RttRead
+#ifndef NATIVE_BUILD
+
+emscripten::val RttRead(int index) {
+    if (index < 0 || index >= static_cast<int>(rtt.up.size())) {
+        throw std::runtime_error("Invalid RTT channel");
+    }
+    rttReadBuffer.clear();
+    rttReadBuffer.swap(rtt.up[index].pending);
+    return emscripten::val(emscripten::typed_memory_view(rttReadBuffer.size(), rttReadBuffer.data()));
+}
+
+#endif
+
+void RttStop() {
+    rtt.valid = false;
+    rtt.up.clear();
+    rtt.down.clear();
+}
+
+// DWT PC sampling profiler, PCSR is read over MEM-AP while core keeps running
+const uint32_t DEMCR = 0xe000edfc;
+const uint32_t DEMCR_TRCENA = 1 << 24;
+const uint32_t DWT_BASE = 0xe0001000;
+const uint32_t DWT_PCSR = 0x1c;
+const uint32_t PCSR_INVALID = 0xffffffff;  // core halted, in lockup or non-invasive debug disabled
+const uint32_t MEM_AP_CSW_NO_INCREMENT = 0x22000002;
+
+struct ProfilerStats {
+    int samples;
+    int invalid;
+    int unique;
+};
+
+struct Profiler {
+    bool running;
+    uint8_t apsel;
+    uint32_t pcsr;
+    uint32_t demcr;
+    uint32_t samples;
+    uint32_t invalid;
+    std::map<uint32_t, uint32_t> histogram;
+};
+
+Profiler profiler{};
+std::vector<uint32_t> profilerSamples;
+std::vector<int32_t> profilerHistogram;
+
+void MemAPWriteWord(uint8_t apsel, uint32_t address, uint32_t data) {
+    select_ap(static_cast<uint32_t>(apsel) << 24);
+    dap::Transfer transfer(txBuffer, txBufferSize);
+    transfer.write<dap::Port::AP, dap::AP_CSW>(MEM_AP_CSW)
+            .write<dap::Port::AP, dap::AP_TAR>(address)
+            .write<dap::Port::AP, dap::AP_DRW>(data);
+    writeReadProbeData();
+    checkTransferResponse(transfer.count());
+}
+
+// Enables trace (DEMCR.TRCENA) and clears histogram, DWT from component map is used when discovered
+void ProfilerStart(int apsel) {
+    const auto *dwt = findComponent(CoreSightType::DWT);
+    if (apsel < 0) {
+        apsel = dwt ? dwt->apsel : GetMemAP();
+        if (apsel < 0) {
+            throw std::runtime_error("MEM-AP is not known, discover components first");
+        }
+    }
+    uint32_t demcr;
+    MemAPReadBlock(static_cast<uint8_t>(apsel), DEMCR, &demcr, 1);
+    if (!(demcr & DEMCR_TRCENA)) {
+        memoryCacheWritten(DEMCR, sizeof(uint32_t));
+        MemAPWriteWord(static_cast<uint8_t>(apsel), DEMCR, demcr | DEMCR_TRCENA);
+    }
+    profiler = {};
+    profiler.running = true;
+    profiler.apsel = static_cast<uint8_t>(apsel);
+    profiler.pcsr = (dwt && dwt->apsel == apsel ? dwt->address : DWT_BASE) + DWT_PCSR;
+    profiler.demcr = demcr;
+}
+
+// Reads PCSR count times, TAR is set once and all reads go out as DAP_TransferBlock packets, returns valid samples
+int ProfilerSample(int count) {
+    if (!profiler.running) {
+        throw std::runtime_error("Profiler is not started");
+    }
+    if (count <= 0) {
+        return 0;
+    }
+    select_ap(static_cast<uint32_t>(profiler.apsel) << 24);
+    dap::Transfer transfer(txBuffer, txBufferSize);
+    transfer.write<dap::Port::AP, dap::AP_CSW>(MEM_AP_CSW_NO_INCREMENT).write<dap::Port::AP, dap::AP_TAR>(profiler.pcsr);
+    writeReadProbeData();
+    checkTransferResponse(transfer.count());
+
+    profilerSamples.resize(count);
+    uint32_t size = count;
+    ReadBlockDPAP(0, dap::READ<dap::Port::AP, dap::AP_DRW>, &size, profilerSamples.data());
+    int valid = 0;
+    for (uint32_t pc: profilerSamples) {
+        if (pc == PCSR_INVALID) {
+            profiler.invalid++;
+            continue;
+        }
+        profiler.histogram[pc]++;
+        valid++;
+    }
+    profiler.samples += count;
+    return valid;
+}
+
+ProfilerStats ProfilerGetStats() {
+    return {static_cast<int>(profiler.samples), static_cast<int>(profiler.invalid), static_cast<int>(profiler.histogram.size())};
+}
+
+// Returns (pc, count) pairs ordered by count, view is valid until next call
+#ifndef NATIVE_BUILD
+
+emscripten::val ProfilerGetHistogram() {
+    std::vector<std::pair<uint32_t, uint32_t>> entries(profiler.histogram.begin(), profiler.histogram.end());
+    std::stable_sort(entries.begin(), entries.end(), [](const auto &a, const auto &b) { return a.second > b.second; });
+    profilerHistogram.clear();
+    for (const auto &entry: entries) {
+        profilerHistogram.push_back(static_cast<int32_t>(entry.first));
+        profilerHistogram.push_back(static_cast<int32_t>(entry.second));
+    }
+    return emscripten::val(emscripten::typed_memory_view(profilerHistogram.size(), profilerHistogram.data()));
+}
+
+#endif
+
+// Restores DEMCR.TRCENA, collected histogram is kept
+void ProfilerStop() {
+    if (!profiler.running) {
+        return;
+    }
+    profiler.running = false;
+    if (!(profiler.demcr & DEMCR_TRCENA)) {
+        memoryCacheWritten(DEMCR, sizeof(uint32_t));
+        MemAPWriteWord(profiler.apsel, DEMCR, profiler.demcr);
+    }
+}
+
+// Target memory layout set by host (or by simulator), reported to debugger as qXfer:memory-map
+enum class MemoryRegionType {
+    Ram = 0,
+    Flash = 1,
+    Rom = 2,
+    Peripheral = 3,
+};
+
+struct MemoryRegion {
+    int type;  // MemoryRegionType
+    uint32_t base;
+    uint32_t size;
+    uint32_t blockSize;  // flash erase block
+};
+
+std::vector<MemoryRegion> memoryRegions;
+
+void AddMemoryRegion(const MemoryRegion &region) {
+    if (region.size == 0 || region.base + (region.size - 1) < region.base || region.type < 0 ||
+        region.type > static_cast<int>(MemoryRegionType::Peripheral)) {
+        throw std::runtime_error("Invalid memory region");
+    }
+    for (const auto &other: memoryRegions) {
+        if (region.base <= other.base + (other.size - 1) && other.base <= region.base + (region.size - 1)) {
+            throw std::runtime_error("Memory region overlaps another one");
+        }
+    }
+    auto position = std::upper_bound(memoryRegions.begin(), memoryRegions.end(), region.base,
+                                     [](uint32_t base, const MemoryRegion &other) { return base < other.base; });
+    memoryRegions.insert(position, region);
+    memoryCache.clear();
+}
+
+void ClearMemoryRegions() {
+    memoryRegions.clear();
+    memoryCache.clear();
+}
+
+// Writes words over MEM-AP with DAP_TransferBlock, TAR is written again at every 1kB auto increment boundary
+void MemAPWriteWords(uint8_t apsel, uint32_t address, const uint32_t *data, uint32_t count) {
+    select_ap(static_cast<uint32_t>(apsel) << 24);
+    while (count) {
+        uint32_t chunk = std::min(count, (0x400 - (address & 0x3ff)) / 4);
+        dap::Transfer transfer(txBuffer, txBufferSize);
+        transfer.write<dap::Port::AP, dap::AP_CSW>(MEM_AP_CSW).write<dap::Port::AP, dap::AP_TAR>(address);
+        writeReadProbeData();
+        checkTransferResponse(transfer.count());
+        WriteBlockDPAP(0, dap::WRITE<dap::Port::AP, dap::AP_DRW>, chunk, data);
+        address += chunk * 4;
+        data += chunk;
+        count -= chunk;
+    }
+}
+
+// Writes up to 3 bytes of one word with byte accesses in one DAP_Transfer, data go on their byte lanes
+void MemAPWriteWordBytes(uint8_t apsel, uint32_t address, const uint8_t *data, uint32_t size) {
+    if (size == 0) {
+        return;
+    }
+    select_ap(static_cast<uint32_t>(apsel) << 24);
+    dap::Transfer transfer(txBuffer, txBufferSize);
+    transfer.write<dap::Port::AP, dap::AP_CSW>(MEM_AP_CSW_BYTE).write<dap::Port::AP, dap::AP_TAR>(address);
+    for (uint32_t i = 0; i < size; i++) {
+        transfer.write<dap::Port::AP, dap::AP_DRW>(static_cast<uint32_t>(data[i]) << (8 * ((address + i) & 0x03)));
+    }
+    writeReadProbeData();
+    checkTransferResponse(transfer.count());
+}
+
+// Writes bytes at any alignment, unaligned head and tail use byte accesses so neighbouring bytes are not rewritten
+void MemAPWriteBytes(uint8_t apsel, uint32_t address, const uint8_t *data, uint32_t size) {
+    uint32_t head = std::min(size, (4 - (address & 0x03)) & 0x03);
+    uint32_t count = (size - head) / 4;
+    uint32_t tail = size - head - count * 4;
+    MemAPWriteWordBytes(apsel, address, data, head);
+    if (count) {
+        std::vector<uint32_t> words(count);
+        for (uint32_t i = 0; i < count; i++) {
+            words[i] = dap::get<dap::Le32>(data + head + 4 * i, sizeof(dap::Le32));
+        }
+        MemAPWriteWords(apsel, address + head, words.data(), count);
+    }
+    MemAPWriteWordBytes(apsel, address + head + count * 4, data + head + count * 4, tail);
+}
+
+const uint32_t AIRCR = 0xe000ed0c;
+const uint32_t AIRCR_SYSRESETREQ = 0x05fa0004;  // VECTKEY | SYSRESETREQ
+const uint32_t DHCSR = 0xe000edf0;
+const uint32_t DHCSR_KEY = 0xa05f0000;
+const uint32_t DHCSR_C_DEBUGEN = 1 << 0;
+const uint32_t DHCSR_C_HALT = 1 << 1;
+const uint32_t DHCSR_C_STEP = 1 << 2;
+const uint32_t DHCSR_C_MASKINTS = 1 << 3;
+const uint32_t DHCSR_S_REGRDY = 1 << 16;
+const uint32_t DHCSR_S_HALT = 1 << 17;
+const uint32_t DCRSR_REGWNR = 1 << 16;
+const uint32_t DEMCR_VC_CORERESET = 1 << 0;
+const uint32_t FPB_BASE = 0xe0002000;
+const uint32_t FP_CTRL_KEY_ENABLE = 0x03;
+const uint32_t PPB_BASE = 0xe0000000;
+const uint32_t PPB_SIZE = 0x100000;
+const uint8_t AP_BD0 = 0x00;  // DHCSR
+const uint8_t AP_BD1 = 0x04;  // DCRSR
+const uint8_t AP_BD2 = 0x08;  // DCRDR
+const int RESET_POLL_COUNT = 100;
+
+// Page cache policy follows memory regions, only pages lying whole in one region are cached:
+// ROM and flash until write or reset, RAM while core is halted, peripherals and unknown memory never
+uint8_t memoryCacheAp = 0;
+
+wix::mem::CachePolicy memoryCachePolicy(uint32_t page) {
+    auto region = std::upper_bound(memoryRegions.begin(), memoryRegions.end(), page,
+                                   [](uint32_t address, const MemoryRegion &other) { return address < other.base; });
+    if (region == memoryRegions.begin()) {
+        return wix::mem::CachePolicy::Never;
+    }
+    --region;
+    uint32_t last = page + (wix::mem::PageCache::PAGE_SIZE - 1);
+    if (last < page || last > region->base + (region->size - 1)) {
+        return wix::mem::CachePolicy::Never;
+    }
+    switch (static_cast<MemoryRegionType>(region->type)) {
+        case MemoryRegionType::Rom:
+        case MemoryRegionType::Flash:
+            return wix::mem::CachePolicy::Always;
+        case MemoryRegionType::Ram:
+            return wix::mem::CachePolicy::Halted;
+        default:
+            return wix::mem::CachePolicy::Never;
+    }
+}
+
+// RAM, flash and ROM are accessed without side effects, so reads there may be widened and joined
+bool sideEffectFree(uint32_t address, uint32_t size) {
+    auto region = std::upper_bound(memoryRegions.begin(), memoryRegions.end(), address,
+                                   [](uint32_t base, const MemoryRegion &other) { return base < other.base; });
+    if (region == memoryRegions.begin() || size == 0) {
+        return false;
+    }
+    --region;
+    return region->type != static_cast<int>(MemoryRegionType::Peripheral) &&
+           static_cast<uint64_t>(address) + size <= static_cast<uint64_t>(region->base) + region->size;
+}
+
+// Write outside of RAM, flash and ROM could halt, resume or reset core (DHCSR, AIRCR) or change memory behind
+// the cache (flash controller, DMA), so all pages are dropped and core state is probed again
+void memoryCacheWritten(uint32_t address, uint32_t size) {
+    if (sideEffectFree(address, size)) {
+        memoryCache.invalidate(address, size);
+    } else if (size > 0) {
+        memoryCache.clear();
+    }
+}
+
+// halt state is known only for Cortex-M core debug behind the same AP, RAM of other targets is not cached
+bool memoryCacheCoreHalted(uint8_t apsel) {
+    const auto *scs = findComponent(CoreSightType::SCS);
+    if (!scs || scs->apsel != apsel) {
+        return false;
+    }
+    uint32_t dhcsr = 0;
+    MemAPReadBlock(apsel, DHCSR, &dhcsr, 1);
+    return (dhcsr & DHCSR_S_HALT) != 0;
+}
+
+void MemoryReadBytes(uint8_t apsel, uint32_t address, uint8_t *data, uint32_t size) {
+    if (apsel != memoryCacheAp) {
+        memoryCache.clear();
+        memoryCacheAp = apsel;
+    }
+    memoryCache.read(
+            address, data, size, memoryCachePolicy, [apsel]() { return memoryCacheCoreHalted(apsel); },
+            [apsel](uint32_t pageAddress, uint8_t *pageData, uint32_t pageSize) { MemAPReadBytes(apsel, pageAddress, pageData, pageSize); });
+}
+
+void MemoryWriteBytes(uint8_t apsel, uint32_t address, const uint8_t *data, uint32_t size) {
+    // dropped upfront, failed write leaves memory in unknown state too
+    memoryCacheWritten(address, size);
+    MemAPWriteBytes(apsel, address, data, size);
+}
+
+inline uint8_t memoryAp(int apsel) {
+    if (apsel < 0) {
+        apsel = GetMemAP();
+        if (apsel < 0) {
+            throw std::runtime_error("MEM-AP is not known, discover components first");
+        }
+    }
+    return static_cast<uint8_t>(apsel);
+}
+
+#ifndef NATIVE_BUILD
+
+// binary data come from host as Uint8Array, embind strings are UTF-8 so bytes can not go through them
+inline void typedArrayBytes(const emscripten::val &input, std::vector<uint8_t> &bytes) {
+    bytes.resize(input["length"].as<unsigned int>());
+    emscripten::val(emscripten::typed_memory_view(bytes.size(), bytes.data())).call<void>("set", input);
+}
+
+std::vector<uint8_t> memoryReadBuffer;
+
+// Reads target memory at any alignment through page cache (when enabled), view is valid until next MemoryRead
+emscripten::val MemoryRead(int apsel, uint32_t address, uint32_t size) {
+    memoryReadBuffer.resize(size);
+    MemoryReadBytes(memoryAp(apsel), address, memoryReadBuffer.data(), size);
+    return emscripten::val(emscripten::typed_memory_view(memoryReadBuffer.size(), memoryReadBuffer.data()));
+}
+
+void MemoryWrite(int apsel, uint32_t address, emscripten::val data) {
+    std::vector<uint8_t> bytes;
+    typedArrayBytes(data, bytes);
+    MemoryWriteBytes(memoryAp(apsel), address, bytes.data(), static_cast<uint32_t>(bytes.size()));
+}
+
+#endif
+
+void MemoryCacheEnable(bool enabled) {
+    memoryCache.setEnabled(enabled);
+}
+
+void MemoryCacheInvalidate() {
+    memoryCache.clear();
+}
+
+wix::mem::CacheStats MemoryCacheGetStats() {
+    return memoryCache.stats();
+}
+
+void MemoryCacheResetStats() {
+    memoryCache.resetStats();
+}
+
+// Scatter-gather memory access, runs of plan share DAP_Transfer packets with SELECT, CSW and TAR written only
+// when they change, run goes to DAP_TransferBlock only when it takes fewer packets (long writes)
+const uint32_t MEM_AP_CSW_SIZE_HALFWORD = 0x01;
+const uint32_t MEM_AP_CSW_SIZE_WORD = 0x02;
+
+// bytes of one access placed on their byte lanes of DRW
+inline uint32_t laneValue(const uint8_t *data, uint32_t address, uint32_t width) {
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < width; i++) {
+        value |= static_cast<uint32_t>(data[i]) << (8 * ((address + i) & 0x03));
+    }
+    return value;
+}
+
+inline void laneBytes(uint32_t value, uint8_t *data, uint32_t address, uint32_t width) {
+    for (uint32_t i = 0; i < width; i++) {
+        data[i] = static_cast<uint8_t>(value >> (8 * ((address + i) & 0x03)));
+    }
+}
+
+std::vector<uint32_t> memoryBlockBuffer;
+
+void MemoryRunPlan(uint8_t apsel, const wix::mem::MemoryPlan &plan) {
+    struct Slot {
+        uint8_t *data;
+        uint32_t address;
+        uint32_t width;
+    };
+
+    const uint64_t UNKNOWN_TAR = ~0ull;
+    const uint32_t select = static_cast<uint32_t>(apsel) << 24;
+    uint32_t csw = 0;
+    uint64_t tar = UNKNOWN_TAR;
+    std::vector<Slot> slots;
+    dap::Transfer transfer(txBuffer, txBufferSize);
+    auto flush = [&]() {
+        if (transfer.count() == 0) {
+            return;
+        }
+        writeReadProbeData();
+        checkTransferResponse(transfer.count());
+        for (std::size_t i = 0; i < slots.size(); i++) {
+            uint32_t value = dap::get<dap::Le32>(rxBuffer, rxBufferSize, sizeof(dap::TransferResponse) + i * sizeof(dap::Le32));
+            laneBytes(value, slots[i].data, slots[i].address, slots[i].width);
+        }
+        slots.clear();
+        transfer = dap::Transfer(txBuffer, txBufferSize);
+    };
+
+    try {
+        for (const auto &run: plan.runs()) {
+            uint32_t runCsw = MEM_AP_CSW_BYTE | (run.width == 4 ? MEM_AP_CSW_SIZE_WORD : run.width == 2 ? MEM_AP_CSW_SIZE_HALFWORD : 0);
+            int setup = (last_ap != select) + (csw != runCsw) + (tar != run.address);
+            int writes = run.write ? 1 : 0;
+            int reads = run.write ? 0 : 1;
+            if (!transfer.fits(setup, setup, 0)) {
+                flush();
+            }
+            // packets needed behind current one, every access costs request byte (and data word) of DAP_Transfer
+            uint32_t fitting = 0;
+            while (fitting < run.count && transfer.fits(setup + fitting + 1, setup + (fitting + 1) * writes, (fitting + 1) * reads)) {
+                fitting++;
+            }
+            uint32_t perTransfer = std::min<uint32_t>(0xff, run.write ? (packetSize - 3) / (1 + sizeof(dap::Le32))
+                                                                      : (packetSize - sizeof(dap::TransferResponse)) / sizeof(dap::Le32));
+            uint32_t perBlock = (packetSize - (run.write ? sizeof(dap::TransferBlockRequest) : sizeof(dap::TransferBlockResponse))) /
+                                sizeof(dap::Le32);
+            uint32_t individual = (run.count - fitting + perTransfer - 1) / perTransfer;
+            uint32_t block = (run.count + perBlock - 1) / perBlock;
+
+            if (last_ap != select) {
+                transfer.write<dap::Port::DP, dap::DP_SELECT>(select);
+                last_ap = select;
+            }
+            if (csw != runCsw) {
+                transfer.write<dap::Port::AP, dap::AP_CSW>(runCsw);
+                csw = runCsw;
+            }
+            if (tar != run.address) {
+                transfer.write<dap::Port::AP, dap::AP_TAR>(run.address);
+            }
+            uint64_t end = run.address + static_cast<uint64_t>(run.count) * run.width;
+            tar = (end & 0x3ff) ? end : UNKNOWN_TAR;  // auto increment wraps at 1kB block
+
+            if (block < individual) {
+                flush();
+                memoryBlockBuffer.resize(run.count);
+                if (run.write) {
+                    for (uint32_t i = 0; i < run.count; i++) {
+                        memoryBlockBuffer[i] = laneValue(run.data + i * run.width, run.address + i * run.width, run.width);
+                    }
+                    WriteBlockDPAP(0, dap::WRITE<dap::Port::AP, dap::AP_DRW>, run.count, memoryBlockBuffer.data());
+                } else {
+                    uint32_t size = run.count;
+                    ReadBlockDPAP(0, dap::READ<dap::Port::AP, dap::AP_DRW>, &size, memoryBlockBuffer.data());
+                    for (uint32_t i = 0; i < run.count; i++) {
+                        laneBytes(memoryBlockBuffer[i], run.data + i * run.width, run.address + i * run.width, run.width);
+                    }
+                }
+                continue;
+            }
+            for (uint32_t i = 0; i < run.count; i++) {
+                if (!transfer.fits(1, writes, reads)) {
+                    flush();
+                }
+                uint32_t address = run.address + i * run.width;
+                if (run.write) {
+                    transfer.write<dap::Port::AP, dap::AP_DRW>(laneValue(run.data + i * run.width, address, run.width));
+                } else {
+                    transfer.read<dap::Port::AP, dap::AP_DRW>();
+                    slots.push_back({run.data + i * run.width, address, run.width});
+                }
+            }
+        }
+        flush();
+    } catch (...) {
+        // SELECT of failed packet is unknown
+        InvalidateSelectCache();
+        throw;
+    }
+}
+
+// Operations are packed little endian triplets [flags (bit 0 write), address, size], data holds bytes of all writes
+// in order and result gets bytes of all reads in order, see wix::mem::MemoryPlan for ordering rules
+void MemoryBatchBytes(uint8_t apsel, const std::vector<uint8_t> &operations, std::vector<uint8_t> &data, std::vector<uint8_t> &result) {
+    const std::size_t OPERATION_SIZE = 3 * sizeof(dap::Le32);
+    if (operations.size() % OPERATION_SIZE != 0) {
+        throw std::runtime_error("Invalid memory batch size");
+    }
+    std::vector<wix::mem::MemoryOperation> list;
+    uint64_t writeSize = 0;
+    uint64_t readSize = 0;
+    for (std::size_t offset = 0; offset < operations.size(); offset += OPERATION_SIZE) {
+        bool write = (dap::get<dap::Le32>(operations.data(), operations.size(), offset) & 0x01) != 0;
+        uint32_t address = dap::get<dap::Le32>(operations.data(), operations.size(), offset + sizeof(dap::Le32));
+        uint32_t size = dap::get<dap::Le32>(operations.data(), operations.size(), offset + 2 * sizeof(dap::Le32));
+        list.push_back({write, address, size, nullptr});
+        (write ? writeSize : readSize) += size;
+    }
+    if (writeSize != data.size()) {
+        throw std::runtime_error("Memory batch data do not match write sizes");
+    }
+    result.assign(readSize, 0);
+    auto *source = data.data();
+    auto *destination = result.data();
+    for (auto &operation: list) {
+        operation.data = operation.write ? source : destination;
+        (operation.write ? source : destination) += operation.size;
+    }
+
+    wix::mem::MemoryPlan plan(list, sideEffectFree);
+    for (const auto &run: plan.runs()) {
+        if (run.write) {
+            memoryCacheWritten(run.address, run.count * run.width);
+        }
+    }
+    MemoryRunPlan(apsel, plan);
+    plan.scatter();
+}
+
+#ifndef NATIVE_BUILD
+
+std::vector<uint8_t> memoryBatchOperations;
+std::vector<uint8_t> memoryBatchData;
+std::vector<uint8_t> memoryBatchResult;
+
+// operations and data are Uint8Array, returned view of read bytes is valid until next MemoryBatch
+emscripten::val MemoryBatch(int apsel, emscripten::val operations, emscripten::val data) {
+    typedArrayBytes(operations, memoryBatchOperations);
+    typedArrayBytes(data, memoryBatchData);
+    MemoryBatchBytes(memoryAp(apsel), memoryBatchOperations, memoryBatchData, memoryBatchResult);
+    return emscripten::val(emscripten::typed_memory_view(memoryBatchResult.size(), memoryBatchResult.data()));
+}
+
+#endif
+
+// GDB server target, core registers go through DCRSR/DCRDR mapped to AP banked data registers (TAR = DHCSR),
+// so register file is transferred in one DAP_Transfer when packet is large enough
+
+class DapGdbTarget : public wix::gdb::Target {
+ public:
+    explicit DapGdbTarget(uint8_t apsel)
+        : apsel(apsel) {
+    }
+
+    void readMemory(uint32_t address, uint8_t *data, uint32_t size) override {
+        recover([&]() { MemoryReadBytes(apsel, address, data, size); });
+    }
+
+    void writeMemory(uint32_t address, const uint8_t *data, uint32_t size) override {
+        recover([&]() { MemoryWriteBytes(apsel, address, data, size); });
+    }
+
+    void readRegisters(uint32_t *values) override {
+        recover([&]() {
+            int index = 0;
+            bool setup = true;
+            while (index < wix::gdb::REGISTER_COUNT) {
+                dap::Transfer transfer(txBuffer, txBufferSize);
+                if (setup) {
+                    selectDebugRegisters(transfer);
+                    setup = false;
+                }
+                int first = index;
+                for (; index < wix::gdb::REGISTER_COUNT && transfer.fits(3, 1, 2); index++) {
+                    transfer.write<dap::Port::AP, AP_BD1>(index).read<dap::Port::AP, AP_BD0>().read<dap::Port::AP, AP_BD2>();
+                }
+                exchange(transfer, first == index);
+                for (int i = first; i < index; i++) {
+                    std::size_t offset = sizeof(dap::TransferResponse) + (i - first) * 2 * sizeof(dap::Le32);
+                    checkRegisterReady(dap::get<dap::Le32>(rxBuffer, rxBufferSize, offset));
+                    values[i] = dap::get<dap::Le32>(rxBuffer, rxBufferSize, offset + sizeof(dap::Le32));
+                }
+            }
+        });
+    }
+
+    void writeRegisters(const uint32_t *values, uint32_t mask) override {
+        recover([&]() {
+            int index = 0;
+            bool setup = true;
+            while (index < wix::gdb::REGISTER_COUNT) {
+                dap::Transfer transfer(txBuffer, txBufferSize);
+                if (setup) {
+                    selectDebugRegisters(transfer);
+                    setup = false;
+                }
+                int reads = 0;
+                bool empty = true;
+                for (; index < wix::gdb::REGISTER_COUNT; index++) {
+                    if (!(mask & (1u << index))) {
+                        continue;
+                    } else if (!transfer.fits(3, 2, 1)) {
+                        break;
+                    }
+                    transfer.write<dap::Port::AP, AP_BD2>(values[index])
+                            .write<dap::Port::AP, AP_BD1>(index | DCRSR_REGWNR)
+                            .read<dap::Port::AP, AP_BD0>();
+                    reads++;
+                    empty = false;
+                }
+                if (transfer.count() == 0) {
+                    break;
+                }
+                exchange(transfer, empty && index < wix::gdb::REGISTER_COUNT);
+                for (int i = 0; i < reads; i++) {
+                    checkRegisterReady(dap::get<dap::Le32>(rxBuffer, rxBufferSize, sizeof(dap::TransferResponse) + i * sizeof(dap::Le32)));
+                }
+            }
+        });
+    }
+
+    void halt() override {
+        recover([&]() { MemAPWriteWord(apsel, DHCSR, DHCSR_KEY | DHCSR_C_DEBUGEN | DHCSR_C_HALT); });
+        if (memoryCache.enabled()) {
+            halted();  // page cache learns halt state
+        }
+    }
+
+    // C_MASKINTS may change only while C_HALT stays set, so it is set (step) or cleared (continue) by halted write first
+    void resume(bool step) override {
+        uint32_t control = DHCSR_KEY | DHCSR_C_DEBUGEN | (step ? DHCSR_C_MASKINTS : 0);
+        memoryCache.setHalted(false);
+        recover([&]() {
+            select_ap(static_cast<uint32_t>(apsel) << 24);
+            dap::Transfer transfer(txBuffer, txBufferSize);
+            transfer.write<dap::Port::AP, dap::AP_CSW>(MEM_AP_CSW_NO_INCREMENT)
+                    .write<dap::Port::AP, dap::AP_TAR>(DHCSR)
+                    .write<dap::Port::AP, dap::AP_DRW>(control | DHCSR_C_HALT)
+                    .write<dap::Port::AP, dap::AP_DRW>(control | (step ? DHCSR_C_STEP : 0));
+            writeReadProbeData();
+            checkTransferResponse(transfer.count());
+        });
+    }
+
+    bool halted() override {
+        uint32_t dhcsr = 0;
+        recover([&]() { MemAPReadBlock(apsel, DHCSR, &dhcsr, 1); });
+        if (apsel == memoryCacheAp) {
+            memoryCache.setHalted((dhcsr & DHCSR_S_HALT) != 0);
+        }
+        return (dhcsr & DHCSR_S_HALT) != 0;
+    }
+
+    // system reset with vector catch, core stops at reset vector
+    void reset() override {
+        memoryCache.clear();
+        recover([&]() {
+            uint32_t demcr;
+            MemAPReadBlock(apsel, DEMCR, &demcr, 1);
+            MemAPWriteWord(apsel, DHCSR, DHCSR_KEY | DHCSR_C_DEBUGEN | DHCSR_C_HALT);
+            MemAPWriteWord(apsel, DEMCR, demcr | DEMCR_VC_CORERESET);
+            MemAPWriteWord(apsel, AIRCR, AIRCR_SYSRESETREQ);
+        });
+        for (int i = 0; i < RESET_POLL_COUNT; i++) {
+            try {
+                if (halted()) {
+                    break;
+                }
+            } catch (const std::runtime_error &) {
+                // debug port could be unreachable for a while during reset
+            }
+        }
+        recover([&]() {
+            uint32_t demcr;
+            MemAPReadBlock(apsel, DEMCR, &demcr, 1);
+            MemAPWriteWord(apsel, DEMCR, demcr & ~DEMCR_VC_CORERESET);
+        });
+    }
+
+    bool breakpoint(uint32_t address, bool insert) override {
+        bool result = false;
+        recover([&]() {
+            if (comparators.empty()) {
+                const auto *fpb = findComponent(CoreSightType::FPB);
+                fpbBase = fpb && fpb->apsel == apsel ? fpb->address : FPB_BASE;
+                uint32_t control;
+                MemAPReadBlock(apsel, fpbBase, &control, 1);
+                fpbRevision = control >> 28;
+                comparators.assign(((control >> 8) & 0x70) | ((control >> 4) & 0x0f), FREE_COMPARATOR);
+                if (comparators.empty()) {
+                    return;
+                }
+                MemAPWriteWord(apsel, fpbBase, FP_CTRL_KEY_ENABLE);
+            }
+            address &= ~0x01u;
+            auto existing = std::find(comparators.begin(), comparators.end(), address);
+            if (!insert) {
+                if (existing != comparators.end()) {
+                    MemAPWriteWord(apsel, fpbBase + 8 + 4 * (existing - comparators.begin()), 0);
+                    *existing = FREE_COMPARATOR;
+                }
+                result = true;
+                return;
+            } else if (existing != comparators.end()) {
+                result = true;
+                return;
+            }
+            auto slot = std::find(comparators.begin(), comparators.end(), FREE_COMPARATOR);
+            // FPBv1 matches halfword of code region word only, FPBv2 takes any instruction address
+            if (slot == comparators.end() || (fpbRevision == 0 && address >= 0x20000000)) {
+                return;
+            }
+            uint32_t comparator = fpbRevision == 0 ? (address & 0x1ffffffc) | ((address & 0x02) ? 0x80000000 : 0x40000000) | 1 : address | 1;
+            MemAPWriteWord(apsel, fpbBase + 8 + 4 * (slot - comparators.begin()), comparator);
+            *slot = address;
+            result = true;
+        });
+        return result;
+    }
+
+    // configured regions, private peripheral bus is added when Cortex-M SCS was discovered
+    std::vector<wix::gdb::MemoryRegion> memoryMap() override {
+        std::vector<wix::gdb::MemoryRegion> regions;
+        bool ppb = findComponent(CoreSightType::SCS) != nullptr;
+        for (const auto &region: memoryRegions) {
+            auto type = static_cast<MemoryRegionType>(region.type);
+            regions.push_back({type == MemoryRegionType::Flash ? wix::gdb::MemoryType::Flash
+                                       : type == MemoryRegionType::Rom ? wix::gdb::MemoryType::Rom
+                                                                       : wix::gdb::MemoryType::Ram,
+                               region.base, region.size, region.blockSize});
+            ppb = ppb && (region.base > PPB_BASE + (PPB_SIZE - 1) || region.base + (region.size - 1) < PPB_BASE);
+        }
+        if (ppb && !regions.empty()) {
+            regions.push_back({wix::gdb::MemoryType::Ram, PPB_BASE, PPB_SIZE, 0});
+        }
+        return regions;
+    }
+
+ private:
+    static constexpr uint32_t FREE_COMPARATOR = 0xffffffff;
+
+    uint8_t apsel;
+    uint32_t fpbBase = FPB_BASE;
+    uint32_t fpbRevision = 0;
+    std::vector<uint32_t> comparators;  // breakpoint address of every FPB code comparator
+
+    // failed access leaves sticky error and unknown SELECT behind, both are cleaned before error goes to debugger
+    template<typename F>
+    void recover(F operation) {
+        try {
+            operation();
+        } catch (const std::runtime_error &) {
+            InvalidateSelectCache();
+            clearStickyErrors();
+            throw;
+        }
+    }
+
+    // TAR points to DHCSR, BD0-BD2 of bank 1 then map DHCSR, DCRSR and DCRDR
+    void selectDebugRegisters(dap::Transfer &transfer) {
+        uint32_t bank = static_cast<uint32_t>(apsel) << 24;
+        transfer.write<dap::Port::DP, dap::DP_SELECT>(bank)
+                .write<dap::Port::AP, dap::AP_CSW>(MEM_AP_CSW_NO_INCREMENT)
+                .write<dap::Port::AP, dap::AP_TAR>(DHCSR)
+                .write<dap::Port::DP, dap::DP_SELECT>(bank | 0x10);
+        last_ap = bank | 0x10;
+    }
+
+    void exchange(const dap::Transfer &transfer, bool empty) {
+        if (empty) {
+            throw std::runtime_error("DAP request exceeds packet size");
+        }
+        writeReadProbeData();
+        checkTransferResponse(transfer.count());
+    }
+
+    static void checkRegisterReady(uint32_t dhcsr) {
+        if (!(dhcsr & DHCSR_S_REGRDY)) {
+            throw std::runtime_error("Core register transfer is not finished, is core halted?");
+        }
+    }
+};
+
+std::unique_ptr<DapGdbTarget> gdbTarget;
+std::unique_ptr<wix::gdb::Server> gdbServer;
+
+// GDB remote serial protocol session, host forwards client bytes to GdbReceive and calls GdbPoll while target runs,
+// core is halted at start and resumed by detach
+void GdbStart(int apsel) {
+    gdbTarget = std::make_unique<DapGdbTarget>(memoryAp(apsel));
+    gdbTarget->halt();  // debugger expects stopped target after attach
+    gdbServer = std::make_unique<wix::gdb::Server>(*gdbTarget);
+}
+
+std::string GdbReceive(const std::string &data) {
+    if (!gdbServer) {
+        throw std::runtime_error("GDB server is not started");
+    }
+    return gdbServer->receive(data);
+}
+
+std::string GdbPoll() {
+    if (!gdbServer) {
+        throw std::runtime_error("GDB server is not started");
+    }
+    return gdbServer->poll();
+}
+
+// host waits for client bytes with timeout and calls GdbPoll while this holds
+bool GdbRunning() {
+    return gdbServer && gdbServer->running();
+}
+
+// client sent detach or kill, host should close connection
+bool GdbDetached() {
+    return gdbServer && gdbServer->detached();
+}
+
+void GdbStop() {
+    gdbServer.reset();
+    gdbTarget.reset();
+}
+
+void WireDisconnect() {
+    dap::put(txBuffer, dap::DisconnectRequest{});
+    writeReadProbeData();
+    auto response = dap::get<dap::StatusResponse>(rxBuffer, rxBufferSize);
+    if (response.command != dap::Command::Disconnect) {
+        throw std::runtime_error("HIF transfer error");
+    } else if (response.status != 0) {
+        throw std::runtime_error("Status error");
+    }
+}
+
+void ProbeReset() {
+    InvalidateSelectCache();
+    memoryCache.clear();
+    dap::put(txBuffer, dap::VendorRequest(0));  // 1 for ISP reset
+    writeReadProbeData();
+    auto response = dap::get<dap::StatusResponse>(rxBuffer, rxBufferSize);
+    if (response.command != dap::Command::Vendor1) {
+        throw std::runtime_error("HIF transfer error");
+    } else if (response.status != 0) {
+        throw std::runtime_error("REDLINK status fail");
+    } else if (dap::get<uint8_t>(rxBuffer, rxBufferSize, 2) <= 0) {
+        throw std::runtime_error("REDLINK status fail 2");
+    }
+}
+
+// host transport reports its packet limit, packets grow up to the size supported by both host and probe
+int SetPacketSize(int hostPacketSize) {
+    int probePacketSize = readInfoValue(0xff);
+    int size = probePacketSize > 0 ? std::min(hostPacketSize, probePacketSize) : hostPacketSize;
+    packetSize = std::max(size, static_cast<int>(dap::MIN_PACKET_SIZE));
+    if (txBufferSize != packetSize) {
+        delete[] txBuffer;
+        txBufferSize = packetSize;
+        txBuffer = new uint8_t[txBufferSize]();
+    }
+    if (rxBufferSize < packetSize) {
+        delete[] rxBuffer;
+        rxBufferSize = packetSize;
+        rxBuffer = new uint8_t[rxBufferSize]();
+    }
+    return static_cast<int>(packetSize);
+}
+
+// CoreSight accesses of independent callers packed into shared DAP_Transfer packets, AP bank switch goes to the same packet
+// op is triplet [flags (bit 0 access port, bit 1 read), address, data], read data replaces op data
+std::vector<uint32_t> batchBuffer;
+
+void CoreSightBatch(uint32_t *ops, int count) {
+    std::vector<int> reads;
+    int next = 0;
+    try {
+        while (next < count) {
+            dap::Transfer transfer(txBuffer, txBufferSize);
+            reads.clear();
+            for (int first = next; next < count; next++) {
+                const uint32_t *op = ops + 3 * next;
+                bool accessPort = (op[0] & 0x01) != 0;
+                bool read = (op[0] & 0x02) != 0;
+                uint32_t select = op[1] & (0xFF000000 | 0x000000F0);
+                bool reselect = accessPort && select != last_ap;
+                if (!transfer.fits(reselect ? 2 : 1, (reselect ? 1 : 0) + (read ? 0 : 1), read ? 1 : 0)) {
+                    if (next == first) {
+                        throw std::runtime_error("DAP request exceeds packet size");
+                    }
+                    break;
+                }
+                if (reselect) {
+                    transfer.write<dap::Port::DP, dap::DP_SELECT>(select);
+                    last_ap = select;
+                }
+                auto port = accessPort ? dap::Port::AP : dap::Port::DP;
+                uint8_t address = accessPort ? op[1] & 0x0c : op[1];
+                if (read) {
+                    transfer.read(port, address);
+                    reads.push_back(next);
+                } else {
+                    transfer.write(port, address, op[2]);
+                    if (accessPort) {
+                        memoryCache.clear();
+                    }
+                }
+            }
+            writeReadProbeData();
+            checkTransferResponse(transfer.count());
+            for (std::size_t i = 0; i < reads.size(); i++) {
+                ops[3 * reads[i] + 2] = dap::get<dap::Le32>(rxBuffer, rxBufferSize, sizeof(dap::TransferResponse) + i * sizeof(dap::Le32));
+            }
+        }
+    } catch (...) {
+        // SELECT of failed packet is unknown
+        InvalidateSelectCache();
+        throw;
+    }
+}
+
+#ifndef NATIVE_BUILD
+
+void CoreSightBatchJS(emscripten::val ops) {
+    auto length = ops["length"].as<unsigned int>();
+    if (length % 3 != 0) {
+        throw std::runtime_error("Invalid CoreSight batch size");
+    }
+    batchBuffer.resize(length);
+    emscripten::val(emscripten::typed_memory_view(length, batchBuffer.data())).call<void>("set", ops);
+    CoreSightBatch(batchBuffer.data(), static_cast<int>(length / 3));
+    // heap could grow during transfer, so view is created again
+    ops.call<void>("set", emscripten::val(emscripten::typed_memory_view(length, batchBuffer.data())));
+}
+
+#endif
+
+void Reset() {
+    InvalidateSelectCache();
+    memoryCache.clear();
+    wix::cout << "Reset target" << std::endl;
+    holdReset(0);
+#ifndef NATIVE_BUILD
+    emscripten_sleep(50 - 3);  // -3ms for USB latency
+#else
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+#endif
+    holdReset(1);
+}
+
+// Simulated CMSIS-DAP probe with ADIv5 target, all following requests are handled in-process without host transport
+void SimulatorStart(const wix::sim::SimulatorConfig &config) {
+    simulator = std::make_unique<wix::sim::DapSimulator>(config);
+    InvalidateSelectCache();
+    memoryCache.clear();
+    executeCommands = false;
+    ClearMemoryRegions();
+    AddMemoryRegion({static_cast<int>(MemoryRegionType::Flash), config.flashBase, config.flashSize, std::min<uint32_t>(config.flashSize, 0x1000)});
+    AddMemoryRegion({static_cast<int>(MemoryRegionType::Ram), config.ramBase, config.ramSize, 0});
+    wix::cout << "Simulator started, packet size: " << config.packetSize << ", WAIT: " << config.waitPercent << "%" << std::endl;
+}
+
+void SimulatorStop() {
+    simulator.reset();
+    InvalidateSelectCache();
+    memoryCache.clear();
+    executeCommands = false;
+    ClearMemoryRegions();
+}
+
+wix::sim::SimulatorStats SimulatorGetStats() {
+    if (!simulator) {
+        throw std::runtime_error("Simulator is not started");
+    }
+    return simulator->stats();
+}
+
+#ifndef NATIVE_BUILD
+
+/** Typed exports for hosts calling wasm without embind wiring **/
+extern "C" {
+EMSCRIPTEN_KEEPALIVE void dapperSetHostTransfer(int enabled) {
+    hostTransfer = enabled != 0;
+    if (hostTransfer && rxBufferSize < 1024) {
+        // response size is not known before host copies it, so reserve the largest HS packet upfront
+        delete[] rxBuffer;
+        rxBufferSize = 1024;
+        rxBuffer = new uint8_t[rxBufferSize];
+    }
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t dapperCoreSightRead(int accessPort, uint32_t address) {
+    return coresight_reg_read(accessPort != 0, address);
+}
+
+EMSCRIPTEN_KEEPALIVE void dapperCoreSightWrite(int accessPort, uint32_t address, uint32_t data) {
+    coresight_reg_write(accessPort != 0, address, data);
+}
+
+EMSCRIPTEN_KEEPALIVE uint32_t *dapperCoreSightBatchBuffer(int count) {
+    batchBuffer.resize(3 * count);
+    return batchBuffer.data();
+}
+
+EMSCRIPTEN_KEEPALIVE void dapperCoreSightBatch(int count) {
+    if (3 * count > batchBuffer.size()) {
+        throw std::runtime_error("Invalid CoreSight batch size");
+    }
+    CoreSightBatch(batchBuffer.data(), count);
+}
+}
+
+// @formatter:off
+EMSCRIPTEN_BINDINGS(module) {
+    /** General API **/
+    emscripten::value_object<DAPCapabilities>("DAPCapabilities")
+            .field("swd", &DAPCapabilities::swd)
+            .field("jtag", &DAPCapabilities::jtag)
+            .field("manchester", &DAPCapabilities::manchester)
+            .field("swoTraceBufferSize", &DAPCapabilities::swoTraceBufferSize)
+            .field("atomic", &DAPCapabilities::atomic)
+            .field("swoStreaming", &DAPCapabilities::swoStreaming);
+
+    emscripten::value_object<DAPFirmwareInfo>("getFirmwareInfo")
+            .field("firmwareVersion", &DAPFirmwareInfo::firmwareVersion)
+            .field("productId", &DAPFirmwareInfo::productId)
+            .field("maxPacketCount", &DAPFirmwareInfo::maxPacketCount)
+            .field("maxPacketSize", &DAPFirmwareInfo::maxPacketSize);
+
+    emscripten::value_object<DAPInfo>("DAPInfo")
+            .field("vendorId", &DAPInfo::vendorId)
+            .field("productId", &DAPInfo::productId)
+            .field("serialNo", &DAPInfo::serialNo)
+            .field("firmwareVer", &DAPInfo::firmwareVer)
+            .field("targetVendor", &DAPInfo::targetVendor)
+            .field("targetName", &DAPInfo::targetName)
+            .field("boardVendor", &DAPInfo::boardVendor)
+            .field("boardName", &DAPInfo::boardName)
+            .field("productFwVer", &DAPInfo::productFwVer)
+            .field("capabilities", &DAPInfo::capabilities)
+            .field("firmwareInfo", &DAPInfo::firmwareInfo);
+
+    emscripten::value_object<DAPTarget>("DAPTarget")
+            .field("handle", &DAPTarget::handle)
+            .field("targetSel", &DAPTarget::targetSel)
+            .field("dpidr", &DAPTarget::dpidr)
+            .field("designer", &DAPTarget::designer)
+            .field("partNo", &DAPTarget::partNo)
+            .field("instance", &DAPTarget::instance)
+            .field("active", &DAPTarget::active);
+    emscripten::function("getProbeDAPInfo", &getProbeDAPInfo);
+    emscripten::function("getSupportedVendorIDs", &getSupportedVendorIDs);
+    emscripten::function("reset", &Reset);
+    emscripten::function("probeReset", &ProbeReset);
+    emscripten::function("setPacketSize", &SetPacketSize);
+
+    /** Debugger API **/
+    emscripten::function("connect", WireConnect);
+    emscripten::function("disconnect", WireDisconnect);
+    emscripten::function("coreSightRead", coresight_reg_read);
+    emscripten::function("coreSightWrite", coresight_reg_write);
+    emscripten::function("coreSightBatch", &CoreSightBatchJS);
+
+    /** Multi-drop API **/
+    emscripten::function("connectMultiDrop", WireConnectMultiDrop);
+    emscripten::function("addTarget", AddTarget);
+    emscripten::function("selectTarget", SelectTarget);
+    emscripten::function("getTargetCount", GetTargetCount);
+    emscripten::function("getTargetInfo", GetTargetInfo);
+
+    /** Discovery API **/
+    emscripten::function("discoverComponents", DiscoverComponents);
+    emscripten::function("restoreComponents", RestoreComponents);
+    emscripten::function("componentMapKey", ComponentMapKey);
+    emscripten::function("getMemAP", GetMemAP);
+
+    /** RTT API **/
+    emscripten::value_object<RttChannelInfo>("RttChannelInfo")
+            .field("index", &RttChannelInfo::index)
+            .field("name", &RttChannelInfo::name)
+            .field("bufferSize", &RttChannelInfo::bufferSize)
+            .field("up", &RttChannelInfo::up);
+    emscripten::function("rttStart", RttStart);
+    emscripten::function("rttStop", RttStop);
+    emscripten::function("rttGetChannelCount", RttGetChannelCount);
+    emscripten::function("rttGetChannelInfo", RttGetChannelInfo);
+    emscripten::function("rttPoll", RttPoll);
+    emscripten::function("rttRead", RttRead);
+
+    /** Profiler API **/
+    emscripten::value_object<ProfilerStats>("ProfilerStats")
+            .field("samples", &ProfilerStats::samples)
+            .field("invalid", &ProfilerStats::invalid)
+            .field("unique", &ProfilerStats::unique);
+    emscripten::function("profilerStart", ProfilerStart);
+    emscripten::function("profilerSample", ProfilerSample);
+    emscripten::function("profilerGetStats", ProfilerGetStats);
+    emscripten::function("profilerGetHistogram", ProfilerGetHistogram);
+    emscripten::function("profilerStop", ProfilerStop);
+
+    /** Simulator API **/
+    emscripten::value_object<wix::sim::SimulatorConfig>("SimulatorConfig")
+            .field("packetSize", &wix::sim::SimulatorConfig::packetSize)
+            .field("waitPercent", &wix::sim::SimulatorConfig::waitPercent)
+            .field("seed", &wix::sim::SimulatorConfig::seed)
+            .field("flashBase", &wix::sim::SimulatorConfig::flashBase)
+            .field("flashSize", &wix::sim::SimulatorConfig::flashSize)
+            .field("ramBase", &wix::sim::SimulatorConfig::ramBase)
+            .field("ramSize", &wix::sim::SimulatorConfig::ramSize)
+            .field("targetId", &wix::sim::SimulatorConfig::targetId)
+            .field("instances", &wix::sim::SimulatorConfig::instances);
+    emscripten::value_object<wix::sim::SimulatorStats>("SimulatorStats")
+            .field("packets", &wix::sim::SimulatorStats::packets)
+            .field("accesses", &wix::sim::SimulatorStats::accesses)
+            .field("waits", &wix::sim::SimulatorStats::waits)
+            .field("faults", &wix::sim::SimulatorStats::faults);
+    emscripten::function("simulatorStart", SimulatorStart);
+    emscripten::function("simulatorStop", SimulatorStop);
+    emscripten::function("simulatorGetStats", SimulatorGetStats);
+
+    /** GDB server API **/
+    emscripten::value_object<MemoryRegion>("MemoryRegion")
+            .field("type", &MemoryRegion::type)
+            .field("base", &MemoryRegion::base)
+            .field("size", &MemoryRegion::size)
+            .field("blockSize", &MemoryRegion::blockSize);
+    emscripten::function("addMemoryRegion", AddMemoryRegion);
+    emscripten::function("clearMemoryRegions", ClearMemoryRegions);
+    emscripten::function("gdbStart", GdbStart);
+    emscripten::function("gdbReceive", GdbReceive);
+    emscripten::function("gdbPoll", GdbPoll);
+    emscripten::function("gdbRunning", GdbRunning);
+    emscripten::function("gdbDetached", GdbDetached);
+    emscripten::function("gdbStop", GdbStop);
+
+    /** Memory access API **/
+    emscripten::value_object<wix::mem::CacheStats>("MemoryCacheStats")
+            .field("hits", &wix::mem::CacheStats::hits)
+            .field("misses", &wix::mem::CacheStats::misses)
+            .field("bypassed", &wix::mem::CacheStats::bypassed)
+            .field("invalidations", &wix::mem::CacheStats::invalidations);
+    emscripten::function("memoryRead", MemoryRead);
+    emscripten::function("memoryWrite", MemoryWrite);
+    emscripten::function("memoryBatch", MemoryBatch);
+    emscripten::function("memoryCacheEnable", MemoryCacheEnable);
+    emscripten::function("memoryCacheInvalidate", MemoryCacheInvalidate);
+    emscripten::function("memoryCacheGetStats", MemoryCacheGetStats);
+    emscripten::function("memoryCacheResetStats", MemoryCacheResetStats);
+}
+// @formatter:on
+#else
+
+// target power-up over CTRL/STAT, system and debug domains are requested together
+void PowerUp() {
+    coresight_reg_write(false, dap::DP_CTRL_STAT, 0x50000f00);
+    for (int retry = 0; retry < 10; retry++) {
+        if ((coresight_reg_read(false, dap::DP_CTRL_STAT) & 0xa0000000) == 0xa0000000) {
+            return;
+        }
+    }
+    throw std::runtime_error("Target power-up failed");
+}
+
+// every received chunk is answered by one send, target state is polled every 10 ms while it runs
+int ServeGdb(int port) {
+    signal(SIGPIPE, SIG_IGN);
+    int listener = socket(AF_INET, SOCK_STREAM, 0);
+    int enabled = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &enabled, sizeof(enabled));
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (listener < 0 || bind(listener, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 || listen(listener, 1) != 0) {
+        wix::cerr << "Can not listen on port " << std::dec << port << std::endl;
+        return 1;
+    }
+    wix::cout << "GDB server listening on localhost:" << std::dec << port << std::endl;
+    while (true) {
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        }
+        setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled));
+        GdbStart(-1);
+        char buffer[4096];
+        while (!GdbDetached()) {
+            pollfd descriptor{client, POLLIN, 0};
+            int ready = poll(&descriptor, 1, GdbRunning() ? 10 : -1);
+            std::string output;
+            try {
+                if (ready > 0) {
+                    auto size = recv(client, buffer, sizeof(buffer), 0);
+                    if (size <= 0) {
+                        break;
+                    }
+                    output = gdbServer->receive(std::string(buffer, size));
+                } else {
+                    output = gdbServer->poll();
+                }
+            } catch (const std::runtime_error &ex) {
+                wix::cerr << "GDB server: " << ex.what() << std::endl;
+            }
+            if (!output.empty() && send(client, output.data(), output.size(), 0) < 0) {
+                break;
+            }
+        }
+        close(client);
+        GdbStop();
+        wix::cout << "GDB client disconnected" << std::endl;
+    }
+}
+
+// Native build has no USB stack, GDB server runs against simulated probe and target
+// (native tests include this file and provide their own entry point)
+#ifndef DAPPER_TEST
+int main(int argc, char *argv[]) {
+    int port = 3333;
+    bool cache = false;
+    wix::sim::SimulatorConfig config{1024, 0, 1, 0x00000000, 0x100000, 0x20000000, 0x40000, 0, 0};
+    for (int i = 1; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--port" && i + 1 < argc) {
+            port = std::stoi(argv[++i]);
+        } else if (option == "--packet-size" && i + 1 < argc) {
+            config.packetSize = std::stoul(argv[++i]);
+        } else if (option == "--wait-percent" && i + 1 < argc) {
+            config.waitPercent = std::stoul(argv[++i]);
+        } else if (option == "--memory-cache") {
+            cache = true;
+        } else {
+            wix::cout << "Usage: " << argv[0] << " [--port 3333] [--packet-size 1024] [--wait-percent 0] [--memory-cache]" << std::endl;
+            return option == "--help" ? 0 : 1;
+        }
+    }
+    try {
+        SimulatorStart(config);
+        SetPacketSize(static_cast<int>(config.packetSize));
+        WireConnect();
+        PowerUp();
+        DiscoverComponents("SIM");
+        MemoryCacheEnable(cache);
+    } catch (const std::runtime_error &ex) {
+        wix::cerr << "Target connection failed: " << ex.what() << std::endl;
+        return 1;
+    }
+    return ServeGdb(port);
+}
+#endif
+
 #endif
@@ -0,0 +1,110 @@
+/* ********************************************************************************************************* *
+ *
+ * Copyright 2025 Oidis
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+ * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+ *
+ * ********************************************************************************************************* */
+
+#include "DapSimulator.hpp"
+#include "DapCommands.hpp"
+#include "Test.hpp"
+
+namespace {
+    using wix::sim::DapSimulator;
+    using wix::sim::SimulatorConfig;
+
+    const uint32_t RAM_BASE = 0x20000000;
+    const uint32_t CSW_WORD = 0x23000002;
+
+    // DAP_Transfer request built access by access, data words are little endian
+    struct Transfer {
+        std::vector<uint8_t> packet{0x05, 0x00, 0x00};
+
+        Transfer &write(bool accessPort, uint8_t address, uint32_t data) {
+            packet.push_back(static_cast<uint8_t>((accessPort ? 0x01 : 0x00) | (address & 0x0c)));
+            for (int i = 0; i < 4; i++) {
+                packet.push_back(static_cast<uint8_t>(data >> (8 * i)));
+            }
+            packet[2]++;
+            return *this;
+        }
+
+        Transfer &read(bool accessPort, uint8_t address) {
+            packet.push_back(static_cast<uint8_t>((accessPort ? 0x01 : 0x00) | 0x02 | (address & 0x0c)));
+            packet[2]++;
+            return *this;
+        }
+    };
+
+    std::vector<uint8_t> run(DapSimulator &simulator, const Transfer &transfer) {
+        std::vector<uint8_t> response(1024);
+        response.resize(simulator.transfer(transfer.packet.data(), transfer.packet.size(), response.data(), response.size()));
+        return response;
+    }
+
+    uint32_t word(const std::vector<uint8_t> &response, std::size_t index) {
+        const uint8_t *data = &response[3 + index * 4];
+        return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    SimulatorConfig config(uint32_t waitPercent = 0) {
+        return SimulatorConfig{1024, waitPercent, 1, 0x00000000, 0x100000, RAM_BASE, 0x40000, 0, 0};
+    }
+}  // namespace
+
+TEST_CASE(simulatorMemoryRoundTrip) {
+    DapSimulator simulator(config());
+    auto response = run(simulator, Transfer()
+                                       .write(false, wix::dap::DP_SELECT, 0)
+                                       .write(true, wix::dap::AP_CSW, CSW_WORD)
+                                       .write(true, wix::dap::AP_TAR, RAM_BASE + 0x100)
+                                       .write(true, 0x0c, 0x12345678)
+                                       .read(true, 0x0c));
+    CHECK_EQUAL(5u, response[1]);
+    CHECK_EQUAL(wix::dap::ACK_OK, response[2]);
+    CHECK_EQUAL(0x12345678u, word(response, 0));
+    CHECK_EQUAL(1u, simulator.stats().packets);
+}
+
+TEST_CASE(simulatorBusErrorIsSticky) {
+    DapSimulator simulator(config());
+    auto response = run(simulator, Transfer()
+                                       .write(true, wix::dap::AP_CSW, CSW_WORD)
+                                       .write(true, wix::dap::AP_TAR, 0x00000000)
+                                       .write(true, 0x0c, 0)  // flash is not writable over MEM-AP
+                                       .read(true, 0x0c));
+    CHECK_EQUAL(2u, response[1]);
+    CHECK_EQUAL(wix::dap::ACK_FAULT, response[2]);
+
+    response = run(simulator, Transfer().read(true, wix::dap::AP_CSW));
+    CHECK_EQUAL(wix::dap::ACK_FAULT, response[2]);
+    response = run(simulator, Transfer().write(false, wix::dap::DP_ABORT, 0x1e).read(true, wix::dap::AP_CSW));
+    CHECK_EQUAL(2u, response[1]);
+    CHECK_EQUAL(wix::dap::ACK_OK, response[2]);
+}
+
+TEST_CASE(simulatorRetriesWaitAcknowledge) {
+    DapSimulator simulator(config(50));
+    run(simulator, Transfer().write(true, wix::dap::AP_CSW, CSW_WORD));
+    for (uint32_t i = 0; i < 32; i++) {
+        auto response = run(simulator, Transfer().write(true, wix::dap::AP_TAR, RAM_BASE + i * 4).write(true, 0x0c, i).read(true, 0x0c));
+        CHECK_EQUAL(3u, response[1]);
+        CHECK_EQUAL(wix::dap::ACK_OK, response[2]);
+        CHECK_EQUAL(i, word(response, 0));
+    }
+    CHECK(simulator.stats().waits > 0);
+}
+
+TEST_CASE(simulatorRejectsPacketOverflow) {
+    SimulatorConfig small = config();
+    small.packetSize = 64;
+    DapSimulator simulator(small);
+    Transfer transfer;
+    for (int i = 0; i < 16; i++) {
+        transfer.write(false, wix::dap::DP_SELECT, 0);
+    }
+    CHECK_THROWS(run(simulator, transfer));
+}
@@ -0,0 +1,267 @@
+/* ********************************************************************************************************* *
+ *
+ * Copyright 2025 Oidis
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+ * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+ *
+ * ********************************************************************************************************* */
+
+#include "GdbServer.hpp"
+#include "Test.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+
+namespace {
+    // target kept in memory, every call is counted
+    class FakeTarget : public wix::gdb::Target {
+     public:
+        std::map<uint32_t, uint8_t> memory;
+        uint32_t registers[wix::gdb::REGISTER_COUNT] = {};
+        std::vector<uint32_t> breakpoints;
+        std::vector<std::pair<uint32_t, uint32_t>> memoryWrites;
+        int registerReads = 0;
+        int registerWrites = 0;
+        int resumes = 0;
+        bool stepping = false;
+        bool isHalted = true;
+        bool stepHalts = true;  // false for core which does not finish instruction (WFI without interrupt)
+
+        void readMemory(uint32_t address, uint8_t *data, uint32_t size) override {
+            for (uint32_t i = 0; i < size; i++) {
+                data[i] = memory[address + i];
+            }
+        }
+
+        void writeMemory(uint32_t address, const uint8_t *data, uint32_t size) override {
+            memoryWrites.emplace_back(address, size);
+            for (uint32_t i = 0; i < size; i++) {
+                memory[address + i] = data[i];
+            }
+        }
+
+        void readRegisters(uint32_t *values) override {
+            registerReads++;
+            std::memcpy(values, registers, sizeof(registers));
+        }
+
+        void writeRegisters(const uint32_t *values, uint32_t mask) override {
+            registerWrites++;
+            for (int i = 0; i < wix::gdb::REGISTER_COUNT; i++) {
+                if (mask & (1u << i)) {
+                    registers[i] = values[i];
+                }
+            }
+        }
+
+        void halt() override {
+            isHalted = true;
+        }
+
+        void resume(bool step) override {
+            resumes++;
+            stepping = step;
+            isHalted = step && stepHalts;
+            if (step) {
+                registers[15] += 2;
+            }
+        }
+
+        bool halted() override {
+            return isHalted;
+        }
+
+        void reset() override {
+            registers[15] = 0x100;
+        }
+
+        bool breakpoint(uint32_t address, bool insert) override {
+            if (address >= 0x20000000) {
+                return false;
+            }
+            if (insert) {
+                breakpoints.push_back(address);
+            } else {
+                breakpoints.erase(std::remove(breakpoints.begin(), breakpoints.end(), address), breakpoints.end());
+            }
+            return true;
+        }
+
+        std::vector<wix::gdb::MemoryRegion> memoryMap() override {
+            return {{wix::gdb::MemoryType::Flash, 0x00000000, 0x100000, 0x1000}, {wix::gdb::MemoryType::Ram, 0x20000000, 0x40000, 0}};
+        }
+    };
+
+    // packet body of the only reply in output, its checksum is verified
+    std::string reply(const std::string &output, bool ack = true) {
+        std::size_t start = ack ? 1 : 0;
+        if (ack && (output.empty() || output[0] != '+')) {
+            throw std::runtime_error("Missing acknowledge in '" + output + "'");
+        }
+        auto hash = output.find('#', start);
+        if (output.size() <= start || output[start] != '$' || hash == std::string::npos || hash + 3 != output.size()) {
+            throw std::runtime_error("Malformed reply '" + output + "'");
+        }
+        std::string body = output.substr(start + 1, hash - start - 1);
+        uint8_t sum = 0;
+        for (char c: body) {
+            sum += static_cast<uint8_t>(c);
+        }
+        if (std::stoul(output.substr(hash + 1), nullptr, 16) != sum) {
+            throw std::runtime_error("Invalid checksum in '" + output + "'");
+        }
+        return body;
+    }
+
+    std::string request(wix::gdb::Server &server, const std::string &payload) {
+        return reply(server.receive(wix::gdb::Server::packet(payload)));
+    }
+
+    // qXfer document read in parts of given size
+    std::string transfer(wix::gdb::Server &server, const std::string &object, uint32_t size, int &parts) {
+        std::string document;
+        parts = 0;
+        while (true) {
+            char offset[32];
+            std::snprintf(offset, sizeof(offset), "%zx,%x", document.size(), size);
+            auto part = request(server, "qXfer:" + object + ":" + offset);
+            parts++;
+            CHECK(!part.empty() && (part[0] == 'm' || part[0] == 'l'));
+            document += part.substr(1);
+            if (part[0] == 'l') {
+                return document;
+            }
+        }
+    }
+}  // namespace
+
+TEST_CASE(gdbChecksumAndAcknowledge) {
+    FakeTarget target;
+    wix::gdb::Server server(target);
+    CHECK(server.receive("$?#3f") == "+$S05#b8");
+    CHECK(server.receive("$?#00") == "-");
+    CHECK(server.receive("-") == "$S05#b8");  // retransmission of last reply
+    CHECK(server.receive("+$?#3") == "");  // acknowledge of reply is skipped, packet is completed by next chunk
+    CHECK(server.receive("f") == "+$S05#b8");
+    CHECK(server.receive("$?#3f$qAttached#8f") == "+$S05#b8+$1#31");
+
+    CHECK(server.receive("$QStartNoAckMode#b0") == "+$OK#9a");
+    CHECK(server.receive("$?#00") == "$S05#b8");  // checksum is not verified without acknowledges
+    CHECK(server.receive("-") == "");
+}
+
+TEST_CASE(gdbReplyEscaping) {
+    CHECK(wix::gdb::Server::packet("OK") == "$OK#9a");
+    auto framed = wix::gdb::Server::packet("a#b$c}d*");
+    CHECK(framed.substr(0, framed.size() - 2) == "$a}\x03" "b}\x04" "c}]d}\x0a#");
+    CHECK(reply(framed, false) == "a}\x03" "b}\x04" "c}]d}\x0a");
+}
+
+TEST_CASE(gdbTransferPaging) {
+    FakeTarget target;
+    wix::gdb::Server server(target);
+    CHECK(request(server, "qSupported:multiprocess+").find("qXfer:memory-map:read+") != std::string::npos);
+
+    int parts = 0;
+    auto features = transfer(server, "features:read:target.xml", 0x40, parts);
+    CHECK(features.find("<?xml") == 0);
+    CHECK(features.find("</target>") == features.size() - 9);
+    CHECK_EQUAL((features.size() + 0x3f) / 0x40, static_cast<std::size_t>(parts));
+    int single = 0;
+    CHECK(transfer(server, "features:read:target.xml", 0x4000, single) == features);
+    CHECK_EQUAL(1, single);
+    CHECK(request(server, "qXfer:features:read:target.xml:10000,100") == "l");
+
+    auto map = transfer(server, "memory-map:read:", 0x20, parts);
+    CHECK(map.find("<memory type=\"flash\" start=\"0x0\" length=\"0x100000\"><property name=\"blocksize\">0x1000</property></memory>") !=
+          std::string::npos);
+    CHECK(map.find("<memory type=\"ram\" start=\"0x20000000\" length=\"0x40000\"/>") != std::string::npos);
+}
+
+TEST_CASE(gdbRegisters) {
+    FakeTarget target;
+    wix::gdb::Server server(target);
+    std::string values;
+    for (int i = 0; i < wix::gdb::REGISTER_COUNT; i++) {
+        char value[9];
+        std::snprintf(value, sizeof(value), "%02x000010", i);
+        values += value;
+    }
+    CHECK(request(server, "G" + values) == "OK");
+    CHECK_EQUAL(1, target.registerWrites);  // all registers in one call
+    CHECK_EQUAL(0x10000003u, target.registers[3]);
+    CHECK(request(server, "g") == values);
+    CHECK_EQUAL(1, target.registerReads);
+
+    CHECK(request(server, "P3=78563412") == "OK");
+    CHECK_EQUAL(0x12345678u, target.registers[3]);
+    CHECK_EQUAL(0x10000004u, target.registers[4]);  // other registers are kept
+    CHECK(request(server, "p3") == "78563412");
+    CHECK(request(server, "p20") == "xxxxxxxx");
+    CHECK(request(server, "P20=00000000") == "E01");
+    CHECK(request(server, "G0102") == "E01");
+}
+
+TEST_CASE(gdbMemory) {
+    FakeTarget target;
+    wix::gdb::Server server(target);
+    CHECK(request(server, "M20000001,3:a1b2c3") == "OK");
+    CHECK(target.memoryWrites == (std::vector<std::pair<uint32_t, uint32_t>>{{0x20000001, 3}}));
+    CHECK(request(server, "m20000000,5") == "00a1b2c300");
+    CHECK(request(server, "M20000001,3:a1b2") == "E01");
+    CHECK(request(server, "m20000000") == "E01");
+}
+
+TEST_CASE(gdbBreakpoints) {
+    FakeTarget target;
+    wix::gdb::Server server(target);
+    CHECK(request(server, "Z0,102,2") == "OK");
+    CHECK(request(server, "Z1,200,2") == "OK");
+    CHECK(target.breakpoints == (std::vector<uint32_t>{0x102, 0x200}));
+    CHECK(request(server, "Z0,20000000,2") == "E0e");
+    CHECK(request(server, "z0,102,2") == "OK");
+    CHECK(target.breakpoints == (std::vector<uint32_t>{0x200}));
+    CHECK(request(server, "Z2,20000000,4") == "");  // watchpoints are not supported
+}
+
+TEST_CASE(gdbStepAndContinue) {
+    FakeTarget target;
+    wix::gdb::Server server(target);
+    target.registers[15] = 0x100;
+    CHECK(request(server, "s") == "S05");
+    CHECK(target.stepping);
+    CHECK_EQUAL(0x102u, target.registers[15]);
+    CHECK(request(server, "s200") == "S05");
+    CHECK_EQUAL(0x202u, target.registers[15]);
+
+    CHECK(server.receive("$c#63") == "+");  // stop reply comes once target halts
+    CHECK(server.running());
+    CHECK(server.poll().empty());
+    target.isHalted = true;
+    CHECK(reply(server.poll(), false) == "S05");
+    CHECK(!server.running());
+
+    CHECK(server.receive("$c#63") == "+");
+    CHECK(reply(server.receive("\x03"), false) == "S02");
+    CHECK(!server.running());
+    CHECK(target.isHalted);
+
+    CHECK(request(server, "D") == "OK");
+    CHECK(server.detached());
+    CHECK(!target.isHalted);
+}
+
+TEST_CASE(gdbStepNotCompleted) {
+    FakeTarget target;
+    wix::gdb::Server server(target);
+    target.stepHalts = false;
+    CHECK(server.receive("$s#73") == "+");  // stop reply comes once step completes
+    CHECK(server.running());
+    CHECK(server.poll().empty());
+    target.isHalted = true;
+    CHECK(reply(server.poll(), false) == "S05");
+    CHECK(!server.running());
+}
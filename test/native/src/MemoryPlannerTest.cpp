@@ -0,0 +1,114 @@
+/* ********************************************************************************************************* *
+ *
+ * Copyright 2025 Oidis
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+ * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+ *
+ * ********************************************************************************************************* */
+
+#include "MemoryPlanner.hpp"
+#include "Test.hpp"
+
+#include <cstring>
+
+namespace {
+    using wix::mem::MemoryOperation;
+    using wix::mem::MemoryPlan;
+
+    // RAM at 0x20000000 is side effect free, everything else behaves as peripheral
+    bool ramOnly(uint32_t address, uint32_t size) {
+        return address >= 0x20000000 && static_cast<uint64_t>(address) + size <= 0x20040000;
+    }
+
+    uint32_t value(const wix::mem::MemoryRun &run, uint32_t index) {
+        uint32_t rv = 0;
+        std::memcpy(&rv, run.data + index * run.width, run.width);
+        return rv;
+    }
+}  // namespace
+
+TEST_CASE(plannerKeepsPeripheralWriteOrder) {
+    // watchdog unlock: two key writes to the same register, then control register below it
+    uint16_t first = 0xC520;
+    uint16_t second = 0xD928;
+    uint32_t control = 0x0001;
+    MemoryPlan plan({{true, 0x4005200E, 2, reinterpret_cast<uint8_t *>(&first)},
+                     {true, 0x4005200E, 2, reinterpret_cast<uint8_t *>(&second)},
+                     {true, 0x40052000, 4, reinterpret_cast<uint8_t *>(&control)}},
+                    ramOnly);
+    const auto &runs = plan.runs();
+    CHECK_EQUAL(3u, runs.size());
+    CHECK_EQUAL(0x4005200Eu, runs[0].address);
+    CHECK_EQUAL(0xC520u, value(runs[0], 0));
+    CHECK_EQUAL(0x4005200Eu, runs[1].address);
+    CHECK_EQUAL(0xD928u, value(runs[1], 0));
+    CHECK_EQUAL(0x40052000u, runs[2].address);
+    CHECK_EQUAL(4u, runs[2].width);
+    CHECK_EQUAL(0x0001u, value(runs[2], 0));
+}
+
+TEST_CASE(plannerKeepsRepeatedPeripheralReads) {
+    uint8_t data[12] = {};
+    MemoryPlan plan({{false, 0x40003008, 4, data}, {false, 0x40003008, 4, data + 4}, {false, 0x40003000, 4, data + 8}}, ramOnly);
+    const auto &runs = plan.runs();
+    CHECK_EQUAL(3u, runs.size());
+    CHECK_EQUAL(0x40003008u, runs[0].address);
+    CHECK_EQUAL(0x40003008u, runs[1].address);
+    CHECK_EQUAL(0x40003000u, runs[2].address);
+
+    for (uint32_t i = 0; i < 3; i++) {
+        uint32_t word = 0x11111111 * (i + 1);
+        std::memcpy(runs[i].data, &word, 4);
+    }
+    plan.scatter();
+    uint32_t words[3];
+    std::memcpy(words, data, sizeof(words));
+    CHECK_EQUAL(0x11111111u, words[0]);
+    CHECK_EQUAL(0x22222222u, words[1]);
+    CHECK_EQUAL(0x33333333u, words[2]);
+}
+
+TEST_CASE(plannerJoinsAscendingPeripheralAccesses) {
+    uint32_t words[3] = {1, 2, 3};
+    MemoryPlan plan({{true, 0x40000000, 4, reinterpret_cast<uint8_t *>(&words[0])},
+                     {true, 0x40000004, 4, reinterpret_cast<uint8_t *>(&words[1])},
+                     {true, 0x40000008, 4, reinterpret_cast<uint8_t *>(&words[2])}},
+                    ramOnly);
+    const auto &runs = plan.runs();
+    CHECK_EQUAL(1u, runs.size());
+    CHECK_EQUAL(3u, runs[0].count);
+    CHECK_EQUAL(3u, value(runs[0], 2));
+}
+
+TEST_CASE(plannerMergesSideEffectFreeWrites) {
+    uint32_t high = 0xAAAAAAAA;
+    uint32_t low = 0x55555555;
+    uint8_t patch = 0xEE;
+    MemoryPlan plan({{true, 0x20000004, 4, reinterpret_cast<uint8_t *>(&high)},
+                     {true, 0x20000000, 4, reinterpret_cast<uint8_t *>(&low)},
+                     {true, 0x20000004, 1, &patch}},
+                    ramOnly);
+    const auto &runs = plan.runs();
+    CHECK_EQUAL(1u, runs.size());
+    CHECK_EQUAL(0x20000000u, runs[0].address);
+    CHECK_EQUAL(2u, runs[0].count);
+    CHECK_EQUAL(0x55555555u, value(runs[0], 0));
+    CHECK_EQUAL(0xAAAAAAEEu, value(runs[0], 1));
+}
+
+TEST_CASE(plannerKeepsOrderBetweenMemoryKinds) {
+    uint32_t command = 0x12;
+    uint32_t buffer = 0x34;
+    uint32_t start = 0x01;
+    MemoryPlan plan({{true, 0x40020004, 4, reinterpret_cast<uint8_t *>(&command)},
+                     {true, 0x20000000, 4, reinterpret_cast<uint8_t *>(&buffer)},
+                     {true, 0x40020000, 4, reinterpret_cast<uint8_t *>(&start)}},
+                    ramOnly);
+    const auto &runs = plan.runs();
+    CHECK_EQUAL(3u, runs.size());
+    CHECK_EQUAL(0x40020004u, runs[0].address);
+    CHECK_EQUAL(0x20000000u, runs[1].address);
+    CHECK_EQUAL(0x40020000u, runs[2].address);
+}
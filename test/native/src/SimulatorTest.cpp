@@ -0,0 +1,461 @@
+/* ********************************************************************************************************* *
+ *
+ * Copyright 2025 Oidis
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+ * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+ *
+ * ********************************************************************************************************* */
+
+// module internals (globals, inline helpers) are reached by including its translation unit
+#include "main.cpp"
+
+#include "Test.hpp"
+
+namespace {
+    const uint32_t FLASH_BASE = 0x00000000;
+    const uint32_t RAM_BASE = 0x20000000;
+
+    // simulated probe and target connected and powered up, torn down on scope exit
+    struct SimulatedTarget {
+        explicit SimulatedTarget(uint32_t packetSize = 1024) {
+            SimulatorStart(wix::sim::SimulatorConfig{packetSize, 0, 1, FLASH_BASE, 0x100000, RAM_BASE, 0x40000, 0, 0});
+            SetPacketSize(static_cast<int>(packetSize));
+            WireConnect();
+            PowerUp();
+        }
+
+        ~SimulatedTarget() {
+            GdbStop();
+            RttStop();
+            profiler = {};
+            MemoryCacheEnable(false);
+            MemoryCacheResetStats();
+            componentMap = {};
+            SimulatorStop();
+        }
+    };
+
+    const uint32_t TARGET_ID = 0x01002927;
+
+    // multi-drop bus with two instances of one target, none selected
+    struct MultiDropBus {
+        MultiDropBus() {
+            SimulatorStart(wix::sim::SimulatorConfig{512, 0, 1, FLASH_BASE, 0x100000, RAM_BASE, 0x40000, TARGET_ID, 2});
+            WireConnectMultiDrop();
+        }
+
+        ~MultiDropBus() {
+            SimulatorStop();
+        }
+    };
+
+    void writeWords(uint32_t address, const std::vector<uint32_t> &words) {
+        MemAPWriteWords(0, address, words.data(), static_cast<uint32_t>(words.size()));
+    }
+
+    uint32_t readWord(uint32_t address) {
+        uint32_t word = 0;
+        MemAPReadWords(0, address, &word, 1);
+        return word;
+    }
+
+    // control block with one up channel (no name) and no down channel
+    void writeRttControlBlock(uint32_t address, uint32_t buffer, uint32_t size) {
+        writeWords(address, {0x47474553, 0x52205245, 0x00005454, 0, 1, 0, 0, buffer, size, 0, 0, 0});
+    }
+
+    // reply body of GDB request, framing is checked by GDB server tests
+    std::string gdb(const std::string &payload) {
+        auto output = GdbReceive(wix::gdb::Server::packet(payload));
+        auto hash = output.rfind('#');
+        if (output.compare(0, 2, "+$") != 0 || hash == std::string::npos) {
+            throw std::runtime_error("Malformed GDB reply '" + output + "'");
+        }
+        return output.substr(2, hash - 2);
+    }
+
+    uint32_t packets() {
+        return SimulatorGetStats().packets;
+    }
+
+    std::string rttPending(int index) {
+        auto &pending = rtt.up[index].pending;
+        std::string data(pending.begin(), pending.end());
+        pending.clear();
+        return data;
+    }
+}  // namespace
+
+TEST_CASE(componentMapRoundTrip) {
+    SimulatedTarget target;
+    for (const std::string name: {"SIM", "", "target with spaces"}) {
+        auto serialized = DiscoverComponents(name);
+        auto components = componentMap.components.size();
+        CHECK(components > 0);
+        componentMap = {};
+        CHECK(RestoreComponents(serialized));
+        CHECK(componentMap.valid);
+        CHECK(componentMap.targetName == name);
+        CHECK_EQUAL(components, componentMap.components.size());
+        CHECK(SerializeComponentMap() == serialized);
+    }
+}
+
+TEST_CASE(componentMapRejectsOtherFormat) {
+    SimulatedTarget target;
+    auto serialized = DiscoverComponents("SIM");
+    componentMap = {};
+    CHECK(!RestoreComponents("dapper-components 1\n" + serialized.substr(serialized.find('\n') + 1)));
+    CHECK(!componentMap.valid);
+}
+
+TEST_CASE(discoveryWalksClass9RomTable) {
+    SimulatedTarget target;
+    DiscoverComponents("SIM");
+    std::vector<std::pair<uint32_t, CoreSightType>> found;
+    for (const auto &component: componentMap.components) {
+        found.emplace_back(component.address, component.type);
+    }
+    // top class 0x1 table, class 0x9 core table and its entries except the skipped one (ITM)
+    CHECK_EQUAL(5u, found.size());
+    CHECK(found[0] == std::make_pair(0xe00ff000u, CoreSightType::RomTable));
+    CHECK(found[1] == std::make_pair(0xe00fe000u, CoreSightType::RomTable));
+    CHECK(found[2] == std::make_pair(0xe000e000u, CoreSightType::SCS));
+    CHECK(found[3] == std::make_pair(0xe0001000u, CoreSightType::DWT));
+    CHECK(found[4] == std::make_pair(0xe0002000u, CoreSightType::FPB));
+}
+
+TEST_CASE(addTargetSelectsKnownTarget) {
+    MultiDropBus bus;
+    int first = AddTarget(TARGET_ID);
+    int second = AddTarget(TARGET_ID | 0x10000000);
+    CHECK(GetTargetInfo(second).active);
+    CHECK_EQUAL(first, AddTarget(TARGET_ID));
+    CHECK(GetTargetInfo(first).active);
+    CHECK(!GetTargetInfo(second).active);
+}
+
+TEST_CASE(addTargetFailsWithoutResponse) {
+    MultiDropBus bus;
+    CHECK_THROWS(AddTarget(TARGET_ID | 0x20000000));
+    CHECK_THROWS(AddTarget(0x01003927));
+    CHECK_EQUAL(0, GetTargetCount());
+}
+
+TEST_CASE(multiDropDiscoveryFindsConfiguredInstances) {
+    MultiDropBus bus;
+    std::vector<uint32_t> found;
+    for (uint32_t instance = 0; instance < 16; instance++) {
+        try {
+            found.push_back(GetTargetInfo(AddTarget((instance << 28) | TARGET_ID)).targetSel);
+        } catch (const std::exception &) {
+            // no target with this instance
+        }
+    }
+    CHECK_EQUAL(2u, found.size());
+    CHECK_EQUAL(TARGET_ID, found[0]);
+    CHECK_EQUAL(TARGET_ID | 0x10000000, found[1]);
+}
+
+TEST_CASE(selectTargetRestoresSelectCache) {
+    MultiDropBus bus;
+    int first = AddTarget(TARGET_ID);
+    CHECK_EQUAL(0x24770011u, coresight_reg_read(true, 0xfc));  // AP IDR, bank 0xf
+    AddTarget(TARGET_ID | 0x10000000);
+    coresight_reg_read(true, 0x00);  // CSW, bank 0 of the other target
+
+    SelectTarget(first);
+    CHECK_EQUAL(0xf0u, last_ap);
+    auto before = packets();
+    CHECK_EQUAL(0x24770011u, coresight_reg_read(true, 0xfc));
+    CHECK_EQUAL(1u, packets() - before);  // no SELECT write, target kept its bank
+}
+
+TEST_CASE(rttPollReadsNewData) {
+    SimulatedTarget target;
+    writeRttControlBlock(RAM_BASE + 0x1000, RAM_BASE + 0x2000, 64);
+    CHECK_EQUAL(1, RttStart(0, RAM_BASE, 0x4000));
+    CHECK_EQUAL(0, RttPoll());
+
+    writeWords(RAM_BASE + 0x2000, {0x6c6c6568, 0x0000006f});  // "hello"
+    writeWords(RAM_BASE + 0x1000 + 24 + 12, {5});
+    CHECK_EQUAL(5, RttPoll());
+    CHECK(rttPending(0) == "hello");
+    CHECK_EQUAL(5u, readWord(RAM_BASE + 0x1000 + 24 + 16));
+    CHECK_EQUAL(0, RttPoll());
+}
+
+TEST_CASE(rttPollReadsUnalignedRing) {
+    SimulatedTarget target;
+    writeRttControlBlock(RAM_BASE + 0x1000, RAM_BASE + 0x2001, 7);
+    RttStart(0, RAM_BASE, 0x4000);
+
+    writeWords(RAM_BASE + 0x2000, {0x63626178, 0x67666564});  // "abcdefg" between 'x' and the end of ring
+    writeWords(RAM_BASE + 0x1000 + 24 + 12, {5});
+    CHECK_EQUAL(5, RttPoll());
+    CHECK(rttPending(0) == "abcde");
+
+    // "fg" up to the end of ring and "hi" wrapped to its start
+    writeWords(RAM_BASE + 0x2000, {0x63696878});
+    writeWords(RAM_BASE + 0x1000 + 24 + 12, {2});
+    CHECK_EQUAL(4, RttPoll());
+    CHECK(rttPending(0) == "fghi");
+
+    uint8_t bytes[10];
+    MemAPReadBytes(0, RAM_BASE + 0x2001, bytes, sizeof(bytes));
+    CHECK(std::string(reinterpret_cast<char *>(bytes), sizeof(bytes)) == std::string("hicdefg\0\0\0", 10));
+}
+
+TEST_CASE(rttPollFollowsReadOffsetMovedByTarget) {
+    SimulatedTarget target;
+    writeRttControlBlock(RAM_BASE + 0x1000, RAM_BASE + 0x2000, 64);
+    RttStart(0, RAM_BASE, 0x4000);
+
+    // another reader consumed "abc" of "abcdef"
+    writeWords(RAM_BASE + 0x2000, {0x64636261, 0x00006665});
+    writeWords(RAM_BASE + 0x1000 + 24 + 12, {6, 3});
+    CHECK_EQUAL(3, RttPoll());
+    CHECK(rttPending(0) == "def");
+    CHECK_EQUAL(6u, readWord(RAM_BASE + 0x1000 + 24 + 16));
+}
+
+TEST_CASE(rttPollFindsMovedControlBlock) {
+    SimulatedTarget target;
+    writeRttControlBlock(RAM_BASE + 0x1000, RAM_BASE + 0x2000, 64);
+    RttStart(0, RAM_BASE, 0x4000);
+    writeWords(RAM_BASE + 0x2000, {0x0a6b6f});  // "ok\n"
+    writeWords(RAM_BASE + 0x1000 + 24 + 12, {3});
+    CHECK_EQUAL(3, RttPoll());
+
+    // restarted firmware placed control block elsewhere, pending data survive resync
+    writeWords(RAM_BASE + 0x1000, {0, 0, 0, 0});
+    writeRttControlBlock(RAM_BASE + 0x3000, RAM_BASE + 0x3800, 32);
+    writeWords(RAM_BASE + 0x3800, {0x00216968});  // "hi!"
+    writeWords(RAM_BASE + 0x3000 + 24 + 12, {3});
+    writeWords(RAM_BASE + 0x1000 + 24 + 16, {0});
+    CHECK_EQUAL(3, RttPoll());
+    CHECK_EQUAL(RAM_BASE + 0x3000, rtt.address);
+    CHECK(rttPending(0) == "ok\nhi!");
+    CHECK_EQUAL(3u, readWord(RAM_BASE + 0x3000 + 24 + 16));
+}
+
+TEST_CASE(rttPollFailsWithoutControlBlock) {
+    SimulatedTarget target;
+    writeRttControlBlock(RAM_BASE + 0x1000, RAM_BASE + 0x2000, 64);
+    RttStart(0, RAM_BASE, 0x4000);
+    writeWords(RAM_BASE + 0x1000, {0, 0, 0, 0});
+    writeWords(RAM_BASE + 0x1000 + 24 + 16, {7});
+    CHECK_THROWS(RttPoll());
+    CHECK(!rtt.valid);
+    CHECK_THROWS(RttPoll());
+}
+
+TEST_CASE(profilerSamplesWithTraceEnabled) {
+    SimulatedTarget target;
+    DiscoverComponents("SIM");
+    CHECK_EQUAL(0u, readWord(DEMCR) & DEMCR_TRCENA);
+    CHECK_EQUAL(PCSR_INVALID, readWord(DWT_BASE + DWT_PCSR));
+
+    ProfilerStart(-1);
+    CHECK(readWord(DEMCR) & DEMCR_TRCENA);
+    CHECK_EQUAL(64, ProfilerSample(64));
+    auto stats = ProfilerGetStats();
+    CHECK_EQUAL(64, stats.samples);
+    CHECK_EQUAL(0, stats.invalid);
+    CHECK(stats.unique > 1);
+
+    ProfilerStop();
+    CHECK_EQUAL(0u, readWord(DEMCR) & DEMCR_TRCENA);
+    CHECK_EQUAL(64, ProfilerGetStats().samples);
+    CHECK_THROWS(ProfilerSample(1));
+}
+
+TEST_CASE(profilerKeepsTraceEnabledByTarget) {
+    SimulatedTarget target;
+    DiscoverComponents("SIM");
+    writeWords(DEMCR, {DEMCR_TRCENA | 0x01});
+    ProfilerStart(-1);
+    ProfilerStop();
+    CHECK_EQUAL(DEMCR_TRCENA | 0x01, readWord(DEMCR));
+}
+
+TEST_CASE(profilerCountsHaltedCoreAsInvalid) {
+    SimulatedTarget target;
+    DiscoverComponents("SIM");
+    writeWords(DHCSR, {DHCSR_KEY | DHCSR_C_HALT | DHCSR_C_DEBUGEN});
+    ProfilerStart(-1);
+    CHECK_EQUAL(0, ProfilerSample(16));
+    CHECK_EQUAL(16, ProfilerGetStats().invalid);
+    ProfilerStop();
+}
+
+TEST_CASE(gdbTargetRegistersInOnePacket) {
+    SimulatedTarget target;
+    DiscoverComponents("SIM");
+    GdbStart(-1);
+    std::string values;
+    for (int i = 0; i < wix::gdb::REGISTER_COUNT; i++) {
+        char value[9];
+        std::snprintf(value, sizeof(value), "%02x0000%02x", i, i == 16 ? 0x01 : 0x20);
+        values += value;
+    }
+    auto before = packets();
+    CHECK(gdb("G" + values) == "OK");
+    CHECK_EQUAL(1u, packets() - before);
+    before = packets();
+    CHECK(gdb("g") == values);
+    CHECK_EQUAL(1u, packets() - before);
+
+    CHECK(gdb("P3=78563412") == "OK");
+    CHECK(gdb("p3") == "78563412");
+    CHECK(gdb("p4") == "04000020");
+}
+
+TEST_CASE(gdbTargetRegistersInSmallPackets) {
+    SimulatedTarget target(64);
+    DiscoverComponents("SIM");
+    GdbStart(-1);
+    auto before = packets();
+    auto values = gdb("g");
+    CHECK_EQUAL(static_cast<std::size_t>(8 * wix::gdb::REGISTER_COUNT), values.size());
+    CHECK(packets() - before > 1);
+    CHECK(gdb("G" + values) == "OK");
+    CHECK(gdb("g") == values);
+}
+
+TEST_CASE(gdbTargetUnalignedMemory) {
+    SimulatedTarget target;
+    DiscoverComponents("SIM");
+    GdbStart(-1);
+    writeWords(RAM_BASE + 0x100, {0xffffffff, 0xffffffff, 0xffffffff});
+    CHECK(gdb("M20000101,6:010203040506") == "OK");
+    CHECK_EQUAL(0x030201ffu, readWord(RAM_BASE + 0x100));
+    CHECK_EQUAL(0xff060504u, readWord(RAM_BASE + 0x104));
+    CHECK_EQUAL(0xffffffffu, readWord(RAM_BASE + 0x108));
+    CHECK(gdb("m20000102,3") == "020304");
+    CHECK(gdb("M00000001,1:55") == "E01");  // flash is programmed by its controller only
+    CHECK(gdb("m20000100,4") == "ff010203");  // probe recovered from bus error
+}
+
+TEST_CASE(gdbTargetBreakpointsOnFpbV1) {
+    SimulatedTarget target;
+    DiscoverComponents("SIM");
+    GdbStart(-1);
+    CHECK(gdb("Z0,100,2") == "OK");
+    CHECK_EQUAL(1u, readWord(FPB_BASE) & 0x01);  // ENABLE, KEY reads as zero
+    CHECK_EQUAL(0x40000101u, readWord(FPB_BASE + 8));  // lower halfword of word at 0x100
+    CHECK(gdb("Z0,102,2") == "OK");
+    CHECK_EQUAL(0x80000101u, readWord(FPB_BASE + 12));  // upper halfword
+    CHECK(gdb("Z0,100,2") == "OK");  // already placed
+    CHECK(gdb("Z1,20000000,2") == "E0e");  // FPBv1 covers code region only
+
+    CHECK(gdb("z0,100,2") == "OK");
+    CHECK_EQUAL(0u, readWord(FPB_BASE + 8));
+    for (uint32_t address = 0x200; address < 0x200 + 5 * 4; address += 4) {
+        char request[32];
+        std::snprintf(request, sizeof(request), "Z1,%x,2", address);
+        CHECK(gdb(request) == "OK");
+    }
+    CHECK(gdb("Z1,300,2") == "E0e");  // all 6 code comparators are used
+}
+
+TEST_CASE(gdbTargetStepAndContinue) {
+    SimulatedTarget target;
+    DiscoverComponents("SIM");
+    GdbStart(-1);
+    CHECK(gdb("P0f=00010000") == "OK");
+    CHECK(gdb("s") == "S05");
+    CHECK(gdb("p0f") == "02010000");
+    // interrupts are masked over step, mask is changed only while core stays halted
+    CHECK_EQUAL(DHCSR_S_HALT | DHCSR_C_MASKINTS, readWord(DHCSR) & (DHCSR_S_HALT | DHCSR_C_MASKINTS));
+
+    CHECK(GdbReceive(wix::gdb::Server::packet("c")) == "+");
+    CHECK(GdbRunning());
+    CHECK_EQUAL(0u, readWord(DHCSR) & (DHCSR_S_HALT | DHCSR_C_MASKINTS));
+    CHECK(GdbPoll().empty());
+    auto stop = GdbReceive("\x03");
+    CHECK(stop.compare(0, 4, "$S02") == 0);
+    CHECK(!GdbRunning());
+    CHECK(readWord(DHCSR) & DHCSR_S_HALT);
+}
+
+TEST_CASE(memoryCacheDroppedByCoreControlWrite) {
+    SimulatedTarget target;
+    DiscoverComponents("SIM");
+    MemoryCacheEnable(true);
+    uint8_t data[8];
+    uint32_t halt = DHCSR_KEY | DHCSR_C_DEBUGEN | DHCSR_C_HALT;
+    MemoryWriteBytes(0, DHCSR, reinterpret_cast<const uint8_t *>(&halt), 4);
+    MemoryReadBytes(0, FLASH_BASE, data, sizeof(data));
+    MemoryReadBytes(0, RAM_BASE, data, sizeof(data));
+    MemoryCacheResetStats();
+    MemoryReadBytes(0, FLASH_BASE, data, sizeof(data));
+    MemoryReadBytes(0, RAM_BASE, data, sizeof(data));
+    CHECK_EQUAL(2u, MemoryCacheGetStats().hits);  // halted core, RAM is cached too
+
+    // RAM write drops written page only
+    MemoryWriteBytes(0, RAM_BASE + 0x800, data, sizeof(data));
+    MemoryReadBytes(0, RAM_BASE, data, sizeof(data));
+    CHECK_EQUAL(3u, MemoryCacheGetStats().hits);
+
+    // core resumed by DHCSR write, RAM must not be served from cache while it runs
+    uint32_t resume = DHCSR_KEY | DHCSR_C_DEBUGEN;
+    MemoryWriteBytes(0, DHCSR, reinterpret_cast<const uint8_t *>(&resume), 4);
+    writeWords(RAM_BASE, {0x12345678});
+    MemoryReadBytes(0, RAM_BASE, data, 4);
+    CHECK_EQUAL(0x78u, data[0]);
+    MemoryReadBytes(0, RAM_BASE, data, 4);
+    CHECK_EQUAL(3u, MemoryCacheGetStats().hits);
+    CHECK_EQUAL(2u, MemoryCacheGetStats().bypassed);
+}
+
+TEST_CASE(memoryCacheFollowsRttAndProfilerWrites) {
+    SimulatedTarget target;
+    DiscoverComponents("SIM");
+    MemoryCacheEnable(true);
+    uint32_t halt = DHCSR_KEY | DHCSR_C_DEBUGEN | DHCSR_C_HALT;
+    MemoryWriteBytes(0, DHCSR, reinterpret_cast<const uint8_t *>(&halt), 4);
+    writeRttControlBlock(RAM_BASE + 0x1000, RAM_BASE + 0x2000, 64);
+    RttStart(0, RAM_BASE, 0x4000);
+    writeWords(RAM_BASE + 0x2000, {0x00216968});  // "hi!"
+    writeWords(RAM_BASE + 0x1000 + 24 + 12, {3});
+
+    // RdOff moved by RTT poll is not served from cached page
+    uint32_t rdOff = 0xffffffff;
+    MemoryReadBytes(0, RAM_BASE + 0x1000 + 24 + 16, reinterpret_cast<uint8_t *>(&rdOff), 4);
+    CHECK_EQUAL(0u, rdOff);
+    CHECK_EQUAL(3, RttPoll());
+    MemoryReadBytes(0, RAM_BASE + 0x1000 + 24 + 16, reinterpret_cast<uint8_t *>(&rdOff), 4);
+    CHECK_EQUAL(3u, rdOff);
+
+    // DEMCR write of profiler drops all pages as any other core control write
+    uint8_t data[4];
+    MemoryReadBytes(0, FLASH_BASE, data, sizeof(data));
+    MemoryCacheResetStats();
+    ProfilerStart(0);
+    MemoryReadBytes(0, FLASH_BASE, data, sizeof(data));
+    ProfilerStop();
+    MemoryReadBytes(0, FLASH_BASE, data, sizeof(data));
+    CHECK_EQUAL(0u, MemoryCacheGetStats().hits);
+}
+
+TEST_CASE(memoryCacheDroppedByPeripheralWrite) {
+    SimulatedTarget target;
+    DiscoverComponents("SIM");
+    AddMemoryRegion({static_cast<int>(MemoryRegionType::Peripheral), 0x40000000, 0x100000, 0});
+    MemoryCacheEnable(true);
+    uint8_t data[4] = {};
+    MemoryReadBytes(0, FLASH_BASE, data, sizeof(data));
+    MemoryReadBytes(0, FLASH_BASE, data, sizeof(data));
+    CHECK_EQUAL(1u, MemoryCacheGetStats().hits);
+
+    // flash controller command could change flash content, simulator has no peripherals so write ends with bus error
+    CHECK_THROWS(MemoryWriteBytes(0, 0x40000000, data, sizeof(data)));
+    InvalidateSelectCache();
+    clearStickyErrors();
+    CHECK_EQUAL(1u, MemoryCacheGetStats().invalidations);
+    MemoryReadBytes(0, FLASH_BASE, data, sizeof(data));
+    CHECK_EQUAL(1u, MemoryCacheGetStats().hits);
+}
@@ -0,0 +1,33 @@
+/* ********************************************************************************************************* *
+ *
+ * Copyright 2025 Oidis
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+ * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+ *
+ * ********************************************************************************************************* */
+
+#include "Test.hpp"
+#include <iostream>
+
+// runs all registered test cases, or only those containing the first argument in their name
+int main(int argc, char *argv[]) {
+    int passed = 0;
+    int failed = 0;
+    for (const auto &test: wix::test::registry()) {
+        if (argc > 1 && std::string(test.name).find(argv[1]) == std::string::npos) {
+            continue;
+        }
+        try {
+            test.body();
+            passed++;
+            std::cout << "[  OK  ] " << test.name << std::endl;
+        } catch (const std::exception &ex) {
+            failed++;
+            std::cout << "[ FAIL ] " << test.name << ": " << ex.what() << std::endl;
+        }
+    }
+    std::cout << passed << " passed, " << failed << " failed" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,82 @@
+/* ********************************************************************************************************* *
+ *
+ * Copyright 2025 Oidis
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+ * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+ *
+ * ********************************************************************************************************* */
+
+#ifndef WEBIX_DAPPER_TEST_HPP_
+#define WEBIX_DAPPER_TEST_HPP_
+
+#include <functional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace wix {
+    namespace test {
+        struct TestCase {
+            const char *name;
+            std::function<void()> body;
+        };
+
+        inline std::vector<TestCase> &registry() {
+            static std::vector<TestCase> cases;
+            return cases;
+        }
+
+        struct Registration {
+            Registration(const char *name, const std::function<void()> &body) {
+                registry().push_back({name, body});
+            }
+        };
+
+        [[noreturn]] inline void fail(const char *file, int line, const std::string &message) {
+            std::ostringstream stream;
+            stream << file << ":" << line << ": " << message;
+            throw std::runtime_error(stream.str());
+        }
+
+        template <typename Expected, typename Actual>
+        void checkEqual(const Expected &expected, const Actual &actual, const char *file, int line, const char *text) {
+            if (!(expected == actual)) {
+                std::ostringstream stream;
+                stream << "CHECK_EQUAL(" << text << ") failed, expected " << std::hex << "0x" << +expected << " got 0x" << +actual;
+                fail(file, line, stream.str());
+            }
+        }
+    }  // namespace test
+}  // namespace wix
+
+#define TEST_CASE(name)                                                      \
+    static void name();                                                      \
+    static const wix::test::Registration name##Registration(#name, name);   \
+    static void name()
+
+#define CHECK(condition)                                                     \
+    do {                                                                     \
+        if (!(condition)) {                                                  \
+            wix::test::fail(__FILE__, __LINE__, "CHECK(" #condition ") failed"); \
+        }                                                                    \
+    } while (false)
+
+#define CHECK_EQUAL(expected, actual) wix::test::checkEqual((expected), (actual), __FILE__, __LINE__, #expected ", " #actual)
+
+#define CHECK_THROWS(expression)                                             \
+    do {                                                                     \
+        bool thrown = false;                                                 \
+        try {                                                                \
+            expression;                                                      \
+        } catch (const std::exception &) {                                   \
+            thrown = true;                                                   \
+        }                                                                    \
+        if (!thrown) {                                                       \
+            wix::test::fail(__FILE__, __LINE__, "CHECK_THROWS(" #expression ") failed"); \
+        }                                                                    \
+    } while (false)
+
+#endif  // WEBIX_DAPPER_TEST_HPP_
@@ -161,6 +161,9 @@ class MockDapper(WebixDapper):
             nonlocal mem_ap_ix
             if mem_ap_ix >= 0:
                 return
+            if instance.mem_ap >= 0:
+                mem_ap_ix = instance.mem_ap
+                return
 
             mem_ap_ix_list = [0, 1, 3]
             mem_ap_address = 0x20000000
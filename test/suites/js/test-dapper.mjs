@@ -52,6 +52,21 @@ class MockDapper extends WebixDapper {
     }
 }
 
+// simulated probe and connected target with discovered components, simulator is stopped when body ends
+async function withSimulatedTarget(config, body) {
+    const dapper = new MockDapper();
+    await dapper.Init();
+    await dapper.SimulatorStart(config);
+    try {
+        await dapper.Connect();
+        await dapper.DiscoverComponents("SIM", null);
+        await body(dapper);
+    } finally {
+        await dapper.SimulatorStop();
+    }
+    return dapper;
+}
+
 describe("test-dapper", function () {
     it("test_getSupportedVendorIDs", async () => {
         const dapper = new MockDapper();
@@ -158,6 +173,108 @@ describe("test-dapper", function () {
         assert.deepEqual(dapper.writeData, data.outbound);
     });
 
+    it("simulated_probe", async () => {
+        const simulated = await withSimulatedTarget({packetSize: 512, waitPercent: 20, seed: 7}, async (dapper) => {
+            assert.equal(await dapper.SetPacketSize(1024), 512);
+            assert.equal(dapper.packetSize, 512);
+            const info = await dapper.getProbeInfo();
+            assert.equal(info.serialNo, "DAPPER-SIM");
+            assert.equal(info.firmwareVer, "2.1.1");
+            assert.equal(dapper.memAP, 0);
+
+            const data = await Promise.all([
+                dapper.CoreSightWrite(true, 0x00, 0x22000012),
+                dapper.CoreSightWrite(true, 0x04, 0x20000100),
+                dapper.CoreSightWrite(true, 0x0c, 0xcafebabe),
+                dapper.CoreSightWrite(true, 0x04, 0x20000100),
+                dapper.CoreSightRead(true, 0x0c)
+            ]);
+            assert.equal(data[4] >>> 0, 0xcafebabe);
+
+            const stats = await dapper.SimulatorGetStats();
+            assert.ok(stats.waits > 0);
+            assert.equal(stats.faults, 0);
+        });
+        assert.equal(simulated.outboundIndex, 0);  // no host transport was used
+    });
+
+    it("core_sight_transaction", async () => {
+        await withSimulatedTarget({}, async (dapper) => {
+            // TAR write and DRW access of concurrent callers must not be interleaved
+            const tarDrw = (address, data) => dapper.CoreSightTransaction([
+                [true, false, 0x04, address],
+                [true, false, 0x0c, data]
+            ]);
+            await Promise.all([
+                dapper.CoreSightWrite(true, 0x00, 0x22000012),
+                tarDrw(0x20000100, 0x11111111),
+                tarDrw(0x20000200, 0x22222222),
+                tarDrw(0x20000300, 0x33333333)
+            ]);
+            const values = await Promise.all([0x20000100, 0x20000200, 0x20000300].map((address) =>
+                dapper.CoreSightTransaction([[true, false, 0x04, address], [true, true, 0x0c]])));
+            assert.deepEqual(values.map((value) => value[1]), [0x11111111, 0x22222222, 0x33333333]);
+        });
+    });
+
+    it("memory_binary_round_trip", async () => {
+        await withSimulatedTarget({}, async (dapper) => {
+            // bytes above 0x7F and NULs are not valid in embind strings
+            const data = Uint8Array.from({length: 0x84}, (_, index) => 0x80 + index);
+            data.set([0x00, 0x01, 0x00, 0xff], 0x80);
+            await dapper.MemoryWrite(0x20000101, data);
+            assert.deepEqual(await dapper.MemoryRead(0x20000101, data.length), data);
+            assert.deepEqual(await dapper.MemoryRead(0x10, 8), new Uint8Array(8).fill(0xff));  // erased flash
+        });
+    });
+
+    it("memory_cache", async () => {
+        await withSimulatedTarget({}, async (dapper) => {
+            await dapper.MemoryCacheEnable();
+
+            const flash = await dapper.MemoryRead(0x10, 0x800);
+            const packets = (await dapper.SimulatorGetStats()).packets;
+            assert.deepEqual(await dapper.MemoryRead(0x10, 0x800), flash);
+            assert.equal((await dapper.SimulatorGetStats()).packets, packets);
+
+            // core runs, so RAM is read from target every time
+            const data = new Uint8Array([0x11, 0x22, 0x33, 0x44, 0x55]);
+            await dapper.MemoryWrite(0x20000003, data);
+            assert.deepEqual(await dapper.MemoryRead(0x20000003, 5), data);
+
+            const stats = await dapper.MemoryCacheGetStats();
+            assert.equal(stats.hits, 3);
+            assert.equal(stats.misses, 3);
+            assert.equal(stats.bypassed, 1);
+        });
+    });
+
+    it("memory_batch", async () => {
+        await withSimulatedTarget({}, async (dapper) => {
+            await dapper.SetPacketSize(1024);
+            const data = Uint8Array.from({length: 1024}, (_, index) => index & 0xff);
+            const rv = await dapper.MemoryBatch([
+                {address: 0x20000001, data},
+                {address: 0x20000101, data: new Uint8Array([0xaa, 0xbb])},
+                {address: 0x20000001, size: data.length},
+                {address: 0x20000100, size: 4}
+            ]);
+            const expected = data.slice();
+            expected.set([0xaa, 0xbb], 0x100);
+            assert.deepEqual(rv[0], expected);
+            assert.deepEqual(rv[1], new Uint8Array([0xff, 0xaa, 0xbb, 0x02]));
+            assert.deepEqual(await dapper.MemoryBatch([]), []);
+
+            // scattered peripheral registers share DAP_Transfer packets
+            const packets = (await dapper.SimulatorGetStats()).packets;
+            const ops = Array.from({length: 256}, (_, index) => ({address: 0xe000e100 + 8 * index, size: 4}));
+            assert.equal((await dapper.MemoryBatch(ops)).length, 256);
+            const stats = await dapper.SimulatorGetStats();
+            assert.ok(stats.packets - packets <= 4);
+            assert.equal(stats.faults, 0);
+        });
+    });
+
     afterEach(async () => {
         if (browser) {
             await browser.close();
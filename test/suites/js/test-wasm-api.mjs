@@ -207,6 +207,10 @@ describe("test-wasm-api", function () {
         assert.deepEqual(error.message, "Exception from JS handler");
     });
 
+    it("test_catch_exception", async () => {
+        assert.deepEqual(await dapper.test_catch_exception(), "caught: Exception from wasm");
+    });
+
     beforeEach(() => {
         stdout = "";
         originalLog = process.stdout.write;
@@ -10,9 +10,12 @@
 # * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
 # *
 # * ********************************************************************************************************* *
+import contextlib
 import json
 import os.path
+import tempfile
 import unittest
+from typing import Iterator
 
 from python.mock_dapper import MockDapper
 
@@ -137,6 +140,92 @@ class DapperIntegrationTest(unittest.TestCase):
         self.assertEqual(self.dapper.outbound_index, len(data["outbound"]))
         self.assertEqual(self.dapper.write_data_trace, data["outbound"])
 
+    @contextlib.contextmanager
+    def simulated_target(self, **options: int) -> Iterator[None]:
+        """Simulated probe and connected target with discovered components, stopped on exit."""
+        self.dapper.init()
+        self.dapper.simulator_start(**options)
+        try:
+            self.dapper.connect()
+            with tempfile.TemporaryDirectory() as cache_dir:
+                self.dapper.discover_components("SIM", cache_dir)
+            yield
+        finally:
+            self.dapper.simulator_stop()
+
+    def test_simulated_probe(self) -> None:
+        with self.simulated_target(packet_size=512, wait_percent=20, seed=7):
+            self.assertEqual(512, self.dapper.set_packet_size(1024))
+            rv = self.dapper.get_probe_dap_info()
+            self.assertEqual("DAPPER-SIM", rv.serial_no)
+            self.assertEqual("2.1.1", rv.firmware_ver)
+            self.assertEqual(0, self.dapper.mem_ap)
+
+            rv = self.dapper.core_sight_batch(
+                [
+                    (True, False, 0x00, 0x22000012),
+                    (True, False, 0x04, 0x20000100),
+                    (True, False, 0x0C, 0xCAFEBABE),
+                    (True, False, 0x04, 0x20000100),
+                    (True, True, 0x0C, 0),
+                ]
+            )
+            self.assertEqual(0xCAFEBABE, rv[4])
+
+            stats = self.dapper.simulator_stats()
+            self.assertGreater(stats["waits"], 0)
+            self.assertEqual(0, stats["faults"])
+
+    def test_memory_cache(self) -> None:
+        with self.simulated_target():
+            self.dapper.memory_cache_enable()
+
+            flash = self.dapper.memory_read(0x10, 0x800)
+            packets = self.dapper.simulator_stats()["packets"]
+            self.assertEqual(flash, self.dapper.memory_read(0x10, 0x800))
+            self.assertEqual(packets, self.dapper.simulator_stats()["packets"])
+
+            # core runs, so RAM is read from target every time
+            self.dapper.memory_write(0x20000003, b"\x11\x22\x33\x44\x55")
+            self.assertEqual(b"\x11\x22\x33\x44\x55", self.dapper.memory_read(0x20000003, 5))
+
+            stats = self.dapper.memory_cache_stats()
+            self.assertEqual(3, stats["hits"])
+            self.assertEqual(3, stats["misses"])
+            self.assertEqual(1, stats["bypassed"])
+
+    def test_memory_binary_round_trip(self) -> None:
+        with self.simulated_target():
+            # bytes above 0x7F and NULs are not valid in embind strings
+            data = bytes(range(0x80, 0x100)) + b"\x00\x01\x00\xFF"
+            self.dapper.memory_write(0x20000101, data)
+            self.assertEqual(data, self.dapper.memory_read(0x20000101, len(data)))
+            self.assertEqual(b"\xFF" * 8, self.dapper.memory_read(0x10, 8))  # erased flash
+            self.assertEqual(b"", self.dapper.memory_read(0x20000101, 0))
+
+    def test_memory_batch(self) -> None:
+        with self.simulated_target():
+            self.dapper.set_packet_size(1024)
+            data = bytes(range(256)) * 4
+            rv = self.dapper.memory_batch(
+                [
+                    (0x20000001, data),
+                    (0x20000101, b"\xAA\xBB"),
+                    (0x20000001, len(data)),
+                    (0x20000100, 4),
+                ]
+            )
+            self.assertEqual(data[:0x100] + b"\xAA\xBB" + data[0x102:], rv[0])
+            self.assertEqual(bytes([data[0xFF], 0xAA, 0xBB, data[0x102]]), rv[1])
+            self.assertEqual([], self.dapper.memory_batch([]))
+
+            # scattered peripheral registers share DAP_Transfer packets
+            packets = self.dapper.simulator_stats()["packets"]
+            rv = self.dapper.memory_batch([(0xE000E100 + 8 * i, 4) for i in range(256)])
+            self.assertEqual(256, len(rv))
+            self.assertLessEqual(self.dapper.simulator_stats()["packets"] - packets, 4)
+            self.assertEqual(0, self.dapper.simulator_stats()["faults"])
+
     @classmethod
     def setUpClass(cls) -> None:
         super().setUpClass()
@@ -0,0 +1,146 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# * ********************************************************************************************************* *
+# *
+# * Copyright 2025 Oidis
+# *
+# * SPDX-License-Identifier: BSD-3-Clause
+# * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+# * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+# *
+# * ********************************************************************************************************* *
+import asyncio
+import threading
+import unittest
+from typing import Any
+
+from python.dapper import AsyncWebixDapper
+
+
+class BlockingDapper:
+    """WebixDapper stand-in, the first call is held until the test releases it."""
+
+    def __init__(self) -> None:
+        self.calls: list[Any] = []
+        self.release = threading.Event()
+        self.fail = False
+
+    def core_sight_batch(self, ops: list[tuple[bool, bool, int, int]]) -> list[int]:
+        self.release.wait(5)
+        self.calls.append(list(ops))
+        if self.fail:
+            raise RuntimeError("WIRE ACK FAULT")
+        return [0x1000 + address if read else data for _, read, address, data in ops]
+
+    def reset(self) -> None:
+        self.release.wait(5)
+        self.calls.append("reset")
+
+    def close(self) -> None:
+        self.calls.append("close")
+
+
+class AsyncDapperTest(unittest.IsolatedAsyncioTestCase):
+
+    async def asyncSetUp(self) -> None:
+        self.dapper = BlockingDapper()
+        self.session = AsyncWebixDapper(self.dapper)  # type: ignore[arg-type]
+
+    async def asyncTearDown(self) -> None:
+        self.dapper.release.set()
+        await self.session.close()
+
+    async def release(self) -> None:
+        await asyncio.sleep(0.05)
+        self.dapper.release.set()
+
+    async def test_concurrent_accesses_are_coalesced(self) -> None:
+        rv = await asyncio.gather(
+            self.session.core_sight_read(True, 0x00),
+            self.session.core_sight_read(True, 0x04),
+            self.session.core_sight_write(True, 0x0C, 0x55),
+            self.session.core_sight_read(False, 0x04),
+            self.release(),
+        )
+        self.assertEqual([0x1000, 0x1004, None, 0x1004, None], rv)
+        self.assertEqual(
+            [
+                [(True, True, 0x00, 0)],
+                [(True, True, 0x04, 0), (True, False, 0x0C, 0x55), (False, True, 0x04, 0)],
+            ],
+            self.dapper.calls,
+        )
+
+    async def test_call_keeps_order(self) -> None:
+        await asyncio.gather(
+            self.session.core_sight_read(True, 0x00),
+            self.session.reset(),
+            self.session.core_sight_read(True, 0x04),
+            self.session.core_sight_read(True, 0x08),
+            self.release(),
+        )
+        self.assertEqual(
+            [
+                [(True, True, 0x00, 0)],
+                "reset",
+                [(True, True, 0x04, 0), (True, True, 0x08, 0)],
+            ],
+            self.dapper.calls,
+        )
+
+    async def test_transactions_are_not_interleaved(self) -> None:
+        async def tar_drw(address: int) -> list[int]:
+            return await self.session.core_sight_transaction(
+                [(True, False, 0x04, address), (True, True, 0x0C, 0)]
+            )
+
+        self.session.max_batch = 3
+        rv = await asyncio.gather(
+            self.session.core_sight_read(True, 0x00),
+            tar_drw(0x20000000),
+            tar_drw(0x20000100),
+            self.release(),
+        )
+        self.assertEqual([0x1000, [0x20000000, 0x100C], [0x20000100, 0x100C], None], rv)
+        self.assertEqual(
+            [
+                [(True, True, 0x00, 0)],
+                [(True, False, 0x04, 0x20000000), (True, True, 0x0C, 0)],
+                [(True, False, 0x04, 0x20000100), (True, True, 0x0C, 0)],
+            ],
+            self.dapper.calls,
+        )
+
+    async def test_transaction_is_coalesced(self) -> None:
+        rv = await asyncio.gather(
+            self.session.core_sight_read(True, 0x00),
+            self.session.core_sight_transaction(
+                [(True, False, 0x04, 0x20000000), (True, True, 0x0C, 0)]
+            ),
+            self.session.core_sight_read(False, 0x04),
+            self.release(),
+        )
+        self.assertEqual([0x1000, [0x20000000, 0x100C], 0x1004, None], rv)
+        self.assertEqual(
+            [
+                [(True, True, 0x00, 0)],
+                [(True, False, 0x04, 0x20000000), (True, True, 0x0C, 0), (False, True, 0x04, 0)],
+            ],
+            self.dapper.calls,
+        )
+
+    async def test_batch_error_is_propagated(self) -> None:
+        self.dapper.fail = True
+        rv = await asyncio.gather(
+            self.session.core_sight_read(True, 0x00),
+            self.session.core_sight_read(True, 0x04),
+            self.release(),
+            return_exceptions=True,
+        )
+        self.assertIsInstance(rv[0], RuntimeError)
+        self.assertIsInstance(rv[1], RuntimeError)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,94 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# * ********************************************************************************************************* *
+# *
+# * Copyright 2025 Oidis
+# *
+# * SPDX-License-Identifier: BSD-3-Clause
+# * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+# * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+# *
+# * ********************************************************************************************************* *
+import socket
+import threading
+import unittest
+from typing import Any
+
+from python.dapper import GdbServer
+
+
+class SessionDapper:
+    """WebixDapper stand-in, continue runs the target for two polls."""
+
+    def __init__(self) -> None:
+        self.calls: list[Any] = []
+        self.running = False
+        self.detached = False
+        self.polls = 0
+
+    def gdb_start(self, ap_sel: int) -> None:
+        self.calls.append(("start", ap_sel))
+
+    def gdb_receive(self, data: bytes) -> bytes:
+        self.calls.append(data)
+        if b"$c#63" in data:
+            self.running = True
+            return b"+"
+        if b"$D#44" in data:
+            self.detached = True
+        return b"+$OK#9a"
+
+    def gdb_poll(self) -> bytes:
+        self.polls += 1
+        if self.polls < 2:
+            return b""
+        self.running = False
+        return b"$S05#b8"
+
+    def gdb_running(self) -> bool:
+        return self.running
+
+    def gdb_detached(self) -> bool:
+        return self.detached
+
+    def gdb_stop(self) -> None:
+        self.calls.append("stop")
+
+
+class GdbServerTest(unittest.TestCase):
+
+    def setUp(self) -> None:
+        self.dapper = SessionDapper()
+        self.client, connection = socket.socketpair()
+        self.client.settimeout(5)
+        server = GdbServer(self.dapper, ap_sel=2)  # type: ignore[arg-type]
+        self.thread = threading.Thread(target=server.serve, args=(connection,))
+        self.thread.start()
+
+    def tearDown(self) -> None:
+        self.client.close()
+        self.thread.join(5)
+
+    def test_chunk_is_answered_by_one_reply(self) -> None:
+        self.client.sendall(b"$H#48$?#3f")
+        self.assertEqual(b"+$OK#9a", self.client.recv(4096))
+        self.assertEqual([("start", 2), b"$H#48$?#3f"], self.dapper.calls)
+
+    def test_running_target_is_polled(self) -> None:
+        self.client.sendall(b"$c#63")
+        self.assertEqual(b"+", self.client.recv(4096))
+        self.assertEqual(b"$S05#b8", self.client.recv(4096))
+        self.assertEqual(2, self.dapper.polls)
+
+    def test_detach_ends_session(self) -> None:
+        self.client.sendall(b"$D#44")
+        self.assertEqual(b"+$OK#9a", self.client.recv(4096))
+        self.thread.join(5)
+        self.assertFalse(self.thread.is_alive())
+        self.assertEqual("stop", self.dapper.calls[-1])
+
+    def test_disconnect_ends_session(self) -> None:
+        self.client.close()
+        self.thread.join(5)
+        self.assertEqual([("start", 2), "stop"], self.dapper.calls)
@@ -0,0 +1,97 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# * ********************************************************************************************************* *
+# *
+# * Copyright 2025 Oidis
+# *
+# * SPDX-License-Identifier: BSD-3-Clause
+# * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+# * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+# *
+# * ********************************************************************************************************* *
+import os
+import struct
+import tempfile
+import unittest
+
+from python.dapper import SymbolMap, sample_profile
+
+
+def build_elf(symbols: list[tuple[str, int, int, int]]) -> bytes:
+    """Minimal ELF32 with .symtab and .strtab sections, symbol is (name, value, size, info)."""
+    strtab = b"\0"
+    symtab = bytes(16)
+    for name, value, size, info in symbols:
+        symtab += struct.pack("<IIIBBH", len(strtab), value, size, info, 0, 1)
+        strtab += name.encode() + b"\0"
+    symtab_offset = 52
+    strtab_offset = symtab_offset + len(symtab)
+    sh_offset = strtab_offset + len(strtab)
+    header = b"\x7fELF\x01\x01\x01" + bytes(9)
+    header += struct.pack("<HHIIIIIHHHHHH", 2, 40, 1, 0, 0, sh_offset, 0, 52, 0, 0, 40, 3, 0)
+    sections = bytes(40)
+    sections += struct.pack("<IIIIIIIIII", 0, 2, 0, 0, symtab_offset, len(symtab), 2, 1, 4, 16)
+    sections += struct.pack("<IIIIIIIIII", 0, 3, 0, 0, strtab_offset, len(strtab), 0, 0, 1, 0)
+    return header + symtab + strtab + sections
+
+
+class SamplingDapper:
+    """WebixDapper stand-in recording profiler calls."""
+
+    def __init__(self) -> None:
+        self.calls: list[tuple[str, int]] = []
+
+    def profiler_start(self, ap_sel: int) -> None:
+        self.calls.append(("start", ap_sel))
+
+    def profiler_sample(self, count: int) -> int:
+        self.calls.append(("sample", count))
+        return count
+
+    def profiler_stop(self) -> None:
+        self.calls.append(("stop", 0))
+
+    def profiler_histogram(self) -> dict[int, int]:
+        return {0x1010: 5, 0x2000: 3}
+
+
+class ProfilerTest(unittest.TestCase):
+
+    def test_symbols_from_elf(self) -> None:
+        elf = build_elf(
+            [
+                ("main", 0x1001, 0x40, 0x12),
+                ("SysTick_Handler", 0x1041, 0x10, 0x12),
+                ("buffer", 0x20000000, 0x100, 0x11),
+            ]
+        )
+        with tempfile.TemporaryDirectory() as directory:
+            path = os.path.join(directory, "firmware.elf")
+            with open(path, "wb") as file:
+                file.write(elf)
+            symbols = SymbolMap.from_elf(path)
+
+        self.assertEqual(2, len(symbols.symbols))
+        self.assertEqual("main", symbols.resolve(0x1000))
+        self.assertEqual("main", symbols.resolve(0x103E))
+        self.assertEqual("SysTick_Handler", symbols.resolve(0x1040))
+        self.assertIsNone(symbols.resolve(0x1050))
+        self.assertIsNone(symbols.resolve(0x20000000))
+        self.assertEqual(
+            [("main", 7), ("0x00002000", 4), ("SysTick_Handler", 1)],
+            symbols.function_histogram({0x1000: 3, 0x1010: 4, 0x2000: 4, 0x1042: 1}),
+        )
+
+    def test_sample_profile_batches(self) -> None:
+        dapper = SamplingDapper()
+        histogram = sample_profile(dapper, 10000, batch=4096)  # type: ignore[arg-type]
+        self.assertEqual({0x1010: 5, 0x2000: 3}, histogram)
+        self.assertEqual(
+            [("start", -1), ("sample", 4096), ("sample", 4096), ("sample", 1808), ("stop", 0)],
+            dapper.calls,
+        )
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,143 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+#
+# * ********************************************************************************************************* *
+# *
+# * Copyright 2025 Oidis
+# *
+# * SPDX-License-Identifier: BSD-3-Clause
+# * The BSD-3-Clause license for this file can be found in the LICENSE.txt file included with this distribution
+# * or at https://spdx.org/licenses/BSD-3-Clause.html#licenseText
+# *
+# * ********************************************************************************************************* *
+import ctypes
+import time
+import unittest
+from typing import Any
+from unittest import mock
+
+from python.dapper import DapperFactory, Interface, TransportSelector, WebixDapper
+from python.dapper.core import Uint8Array
+
+
+class FakeTransport(Interface[object]):
+    """Probe interface answering DAP_Info packet size after given delay."""
+
+    def __init__(self, kind: str, max_packet_size: int, delay: float, fail: bool = False) -> None:
+        super().__init__(object())
+        self._type = kind
+        self.serial_no = "MCU-LINK-1"
+        self.packet_size = 64
+        self.max_packet_size = max_packet_size
+        self.delay = delay
+        self.fail = fail
+        self.opened = 0
+        self.closed = 0
+        self.requests: list[bytes] = []
+
+    @classmethod
+    def is_available(cls) -> bool:
+        return True
+
+    def open(self) -> None:
+        if self.fail:
+            raise RuntimeError("Unable to claim interface.")
+        self.opened += 1
+
+    def close(self) -> None:
+        self.closed += 1
+
+    def write(self, data: Uint8Array) -> None:
+        self.requests.append(bytes(data.buffer)[0:2])
+
+    def read(self) -> Uint8Array:
+        time.sleep(self.delay)
+        return self._received(bytes([0x00, 0x02, 0x00, 0x04]))  # 1024 B packets
+
+
+def interface_class(*probes: FakeTransport) -> Any:
+    return type("FakeInterface", (), {"list_probes": staticmethod(lambda: list(probes))})
+
+
+class TransportSelectorTest(unittest.TestCase):
+
+    def setUp(self) -> None:
+        TransportSelector.choices.clear()
+        TransportSelector.measurements.clear()
+        self.hid = FakeTransport("hid", 64, 0.001)
+        self.usb_v2 = FakeTransport("usb_v2", 0xFFFF, 0.002)
+
+    def test_fastest_transport_is_selected_once(self) -> None:
+        self.assertIs(self.usb_v2, TransportSelector.select([self.hid, self.usb_v2]))
+        self.assertEqual(
+            [("hid", 64), ("usb_v2", 1024)],
+            [(m.type, m.packet_size) for m in TransportSelector.measurements["MCU-LINK-1"]],
+        )
+        self.assertEqual({b"\x00\xff"}, set(self.hid.requests))
+
+        self.assertIs(self.usb_v2, TransportSelector.select([self.hid, self.usb_v2]))
+        self.assertEqual((1, 1), (self.hid.opened, self.usb_v2.opened))
+
+    def test_failing_transport_is_skipped(self) -> None:
+        self.usb_v2.fail = True
+        self.assertIs(self.hid, TransportSelector.select([self.usb_v2, self.hid]))
+        self.assertEqual(["hid"], [m.type for m in TransportSelector.measurements["MCU-LINK-1"]])
+
+    def test_probe_is_listed_once_by_selected_transport(self) -> None:
+        usb_v1 = FakeTransport("usb_v1", 64, 0.001)
+        interfaces = [
+            interface_class(self.usb_v2),
+            interface_class(usb_v1),
+            interface_class(self.hid),
+        ]
+        with mock.patch(
+            "python.dapper.webix_dapper.InterfaceFactory.load_interfaces", return_value=interfaces
+        ):
+            self.assertEqual([self.usb_v2], DapperFactory.list_probes())
+            self.assertEqual(
+                [self.usb_v2, usb_v1, self.hid], DapperFactory.transports["MCU-LINK-1"]
+            )
+            TransportSelector.choices["MCU-LINK-1"] = "hid"
+            self.assertEqual([self.hid], DapperFactory.list_probes())
+
+    def test_negotiated_packet_size_reaches_interface(self) -> None:
+        dapper = WebixDapper()
+        dapper.interface = self.usb_v2
+        module = mock.Mock(setPacketSize=lambda size: min(size, 1024))
+        with mock.patch.object(WebixDapper, "module", new_callable=mock.PropertyMock) as prop:
+            prop.return_value = module
+            self.assertEqual(1024, dapper.set_packet_size(self.usb_v2.max_packet_size))
+        self.assertEqual(1024, self.usb_v2.packet_size)
+
+    def test_probe_info_leaves_open_session_untouched(self) -> None:
+        session = WebixDapper()
+        session.interface = self.hid
+        module = mock.Mock()
+        module.getProbeDAPInfo.side_effect = [
+            RuntimeError("Probe disconnected."),
+            {"serialNo": "1"},
+        ]
+        WebixDapper.probe_info_cache.clear()
+        with mock.patch.object(DapperFactory, "_dapper", session), mock.patch.object(
+            WebixDapper, "init", lambda dapper: None
+        ), mock.patch.object(WebixDapper, "module", new_callable=mock.PropertyMock) as prop:
+            prop.return_value = module
+            with self.assertRaises(RuntimeError):
+                DapperFactory.probe_info(self.usb_v2)
+            self.assertEqual(1, self.usb_v2.closed)
+            self.assertEqual("1", DapperFactory.probe_info(self.usb_v2).serial_no)
+            DapperFactory.probe_info(self.usb_v2)
+        WebixDapper.probe_info_cache.clear()
+        self.assertIs(self.hid, session.interface)
+        self.assertEqual(2, module.getProbeDAPInfo.call_count)
+        self.assertEqual((2, 2), (self.usb_v2.opened, self.usb_v2.closed))
+
+    def test_read_reuses_receive_buffer(self) -> None:
+        first = self.hid.read()
+        second = self.hid.read()
+        self.assertEqual(4, len(second))
+        self.assertEqual(ctypes.addressof(first.buffer), ctypes.addressof(second.buffer))
+
+
+if __name__ == "__main__":
+    unittest.main()
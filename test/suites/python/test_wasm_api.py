@@ -137,6 +137,10 @@ class DapperAPITest(unittest.TestCase):
             err = e
         self.assertEqual(f"{err}", "Exception from Python handler")
 
+    def test_catch_exception(self) -> None:
+        rv = self.dapper.test_catch_exception()
+        self.assertEqual(rv, "caught: Exception from wasm")
+
     @classmethod
     def setUpClass(cls) -> None:
         super().setUpClass()
@@ -200,6 +200,15 @@ void test_fcn_throw_exception() {
     emscripten::val::global("fcn_throw_exception")();
 }
 
+std::string test_catch_exception() {
+    try {
+        test_throw_exception();
+    } catch (const std::runtime_error &e) {
+        return std::string("caught: ") + e.what();
+    }
+    return "not caught";
+}
+
 // @formatter:off
 EMSCRIPTEN_BINDINGS(module) {
     /* types declaration */
@@ -237,12 +246,13 @@ EMSCRIPTEN_BINDINGS(module) {
 
     emscripten::function("test_throw_exception", test_throw_exception);
     emscripten::function("test_fcn_throw_exception", test_fcn_throw_exception);
+    emscripten::function("test_catch_exception", test_catch_exception);
 }
 // @formatter:on
 #else
 
 int main() {
-    wix::cout << "Hello from dapper CLI interface! There is nothing to dapperize yet, please come back and try me later :-)" << std::endl;
+    // wix::cout < "Hello from dapper CLI interface! There is nothing to dapperize yet, please come back and try me later :-)" << std::endl;
 }
 
 #endif